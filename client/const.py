@@ -1,6 +1,12 @@
-APPDIR = None
-MAJORNAMES = ["A", "B", "C", "D"]
-MINORNAMES = ["1", "2", "3", "4"]
-WEEKDAYNAMES = ["Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"]
-COMMANDNAMES = ["On", "Off"]
-SIZEOFACTION = 10  # size of action-record in bytes in device memory
+APPDIR = None
+MAJORNAMES = ["A", "B", "C", "D"]
+MINORNAMES = ["1", "2", "3", "4"]
+WEEKDAYNAMES = ["Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"]
+COMMANDNAMES = ["On", "Off"]
+SUNNAMES = ["Sunrise", "Sunset"]
+SIZEOFACTION = 11  # size of action-record in bytes in device memory, the last byte is a CRC-8
+SCENESIZE = 16  # maximum number of units switched in a single request
+UNITCONFIGSIZE = 16  # number of entries in the unit configuration table
+LATENESSBUCKETS = 16  # number of buckets in the lateness histogram
+LATENESSWIDTH = 10  # width of a lateness histogram bucket in seconds
+STREAMBLOCK = 32  # number of actions streamed to or from the device in one request (STREAMMAX in timer/main.c)
@@ -1,231 +1,627 @@
-# device.py
-#
-# Setup the serial connection
-# Send commands to - and receive data from the timer device.
-
-import datetime
-import struct
-from collections import namedtuple
-
-import serial
-
-device_info_type = namedtuple("device_info_type", "hw_version sw_version memory_size action_count")
-action_type = namedtuple("action_type", "valid major minor dd mm yy wd hh mn cmd")
-datetime_info_type = namedtuple("datetime_info_type", "date time weekday")
-
-port = None
-
-
-def connect(comport):
-    global port
-
-    try:
-        port = serial.Serial(port=comport, baudrate=9600,
-                             parity=serial.PARITY_NONE, bytesize=serial.EIGHTBITS, stopbits=serial.STOPBITS_ONE)
-        if not port.isOpen():
-            port.open()
-            port.isOpen()
-    except serial.SerialException as e:
-        port = None
-        print("SerialException:", e)
-        return False
-    return True
-
-
-def close():
-    global port
-    if port is not None:
-        port.close()
-        port = None
-
-
-def read(size=1):
-    return port.read(size)
-
-
-def write(data):
-    return port.write(data)
-
-
-# Start the timer
-# Send:     'A'
-# Receive:  '0' or '1'
-#
-def start_timer():
-    write(b"A")
-    r = read(1)
-    return ord(r[0:1])
-
-
-# Stop the timer
-# Send:     'B'
-# Receive:  '0' or '1'
-#
-def stop_timer():
-    write(b"B")
-    r = read(1)
-    return ord(r[0:1])
-
-
-# Read date and time from the device
-# Send:     'C'
-# Receive:  7 bytes - dd, mm, yy, weekday, hh, mm, ss
-#
-def get_datetime():
-    write(b"C")
-    b = read(7)
-    dd = ord(b[0:1])
-    mm = ord(b[1:2])
-    yy = ord(b[2:3])
-    wd = ord(b[3:4])
-    hh = ord(b[4:5])
-    mn = ord(b[5:6])
-    ss = ord(b[6:7])
-
-    date = datetime.date(2000 + yy, mm, dd)
-    time = datetime.time(hh, mn, ss)
-
-    return datetime_info_type(date, time, wd)
-
-
-# Set data and time on the device
-# Send:     'D'
-#           7 bytes: dd, mm, yy, weekday, hh, mm, ss
-# Receive:  '0' or '1'
-#
-def set_datetime():
-    now = datetime.datetime.now()
-
-    b = bytearray()
-
-    b.append(now.day)
-    b.append(now.month)
-    b.append(now.year - 2000)
-    b.append(now.isoweekday())  # monday = 1
-    b.append(now.hour)
-    b.append(now.minute)
-    b.append(now.second)
-
-    write(b"D")
-    write(b)
-
-    r = read(1)
-
-    return ord(r[0:1])
-
-
-# Read an action from the timer device
-# Send:     'E'
-#           2 byte integer for action number
-# Receive:  10 bytes - valid, (char)major, minor, dd, mm, yy, wd, hh, mm, cmd
-#           translated into an action_type tuple
-#
-def get_action(index):
-    write(b"E")
-
-    # H = unsigned short (2 bytes)
-
-    b = struct.pack("H", index)
-    write(b)
-
-    r = read(10)
-
-    # Unpack binary data, B = unsigned char, c = char
-
-    return action_type._make(struct.unpack("BcBBBBBBBB", r))
-
-
-# Send an action to the timer device
-# Send:     'F'
-#           10 bytes - valid, (char)major, minor, dd, mm, yy, wd, hh, mm, cmd (all read from an action_type tuple)
-# Receive:  '0' or '1'
-#
-def set_action(index, action):
-    write(b"F")
-
-    # H = unsigned short (2 bytes)
-
-    b = struct.pack("H", index)
-    write(b)
-
-    # Pack binary date, B = unsigned character
-
-    b = struct.pack("BBBBBBBBBB", action.valid, ord(action.major), action.minor, action.dd, action.mm, action.yy,
-                    action.wd, action.hh, action.mn, action.cmd)
-    write(b)
-
-    r = read(1)
-
-    return ord(r[0:1])
-
-
-# Switch a unit on or off
-# Send:     'G'
-#           3 bytes - major, minor, cmd
-# Receive:  '0' or '1'
-#
-def switch(major, minor, command):
-    write(b"G")
-
-    b = struct.pack("BBB", major, minor, command)
-    write(b)
-
-    r = read(1)
-
-    return ord(r[0:1])
-
-
-# Read device info
-# Send:     'H'
-# Receive:  24 bytes
-#
-def get_info():
-    write(b"H")
-    b = read(24)
-
-    hw_version = b[0:3].decode().lstrip()
-    sw_version = b[3:6].decode().lstrip()
-    memory_size_string = b[6:11].decode()
-    memory_size = 0 if len(memory_size_string) == 0 else int(memory_size_string)
-    action_count_string = b[11:16].decode()
-    action_count = 0 if len(action_count_string) == 0 else int(action_count_string)
-
-    return device_info_type(hw_version, sw_version, memory_size, action_count)
-
-
-# Write device info
-# Send:     'I'
-#           8 bytes
-#
-def set_info(hw_version, memory_type, memory_size):
-    # to avoid accidental use ...
-    if 1:
-        return
-
-    write(b"I")
-
-    b = struct.pack("BB", hw_version, memory_type)
-    write(b)
-    b = struct.pack("IH", memory_size, 0xABFE)
-    write(b)
-
-    # Note: no OK or Error response from device
-
-
-# Print debugging output to the serial port
-# Send:     'J'
-# Receive:  '0' or '1'
-#
-def set_verbose():
-    write(b"J")
-
-    b = read(1)
-
-    return ord(b[0:1])
-
-
-# Force a reset (currently waits for the user the press the reset button
-# Send:     'K'
-#
-def reset():
-    write(b"K")
+# device.py
+#
+# Setup the serial connection
+# Send commands to - and receive data from the timer device.
+
+import datetime
+import struct
+import time
+from collections import namedtuple
+
+import serial
+
+import const
+
+device_info_type = namedtuple("device_info_type",
+                              "hw_version sw_version memory_size action_count max_actions generation layout_version "
+                              "schedule_intact schedule_crc")
+action_type = namedtuple("action_type", "valid major minor dd mm yy wd hh mn cmd")
+# For a date range action (valid == ACTIONRANGE) dd and mm hold the low and high byte of the day
+# number of the first day (days since 1 January 2000) and yy the number of days which follow it
+# For a sun relative action (valid == ACTIONSUNRISE or ACTIONSUNSET) hh and mn hold the low and high
+# byte of the signed offset in minutes; these actions must follow all others in the schedule
+
+ACTIONDATE = 1  # action on a specific date, or on any date
+ACTIONRANGE = 2  # action on a range of dates
+ACTIONSUNRISE = 3  # action relative to sunrise
+ACTIONSUNSET = 4  # action relative to sunset
+RANGEDAYS = 255  # maximum number of days after the first day of a date range action
+datetime_info_type = namedtuple("datetime_info_type", "date time weekday")
+statistics_type = namedtuple("statistics_type",
+                             "loop_latency_max rf_queue_max rf_frames rf_airtime rf_airtime_saved rx_overflows "
+                             "cache_hits cache_misses action_errors action_error_last scrub_passes scrub_time_max")
+unit_config_type = namedtuple("unit_config_type", "major minor repeats turn_on gap")
+log_entry_type = namedtuple("log_entry_type", "timestamp major minor command lateness")
+profile_entry_type = namedtuple("profile_entry_type", "calls total min max")
+memory_type = namedtuple("memory_type", "static_size stack_max free_now free_min")
+lateness_type = namedtuple("lateness_type", "max count")
+
+DLE = 0x10  # escape character for flow control characters in data received from the device
+ACTIONCRC = 0xFF  # start value of the CRC-8 which ends every action record
+
+port = None
+
+
+def connect(comport):
+    global port
+
+    try:
+        port = serial.Serial(port=comport, baudrate=9600,
+                             parity=serial.PARITY_NONE, bytesize=serial.EIGHTBITS, stopbits=serial.STOPBITS_ONE,
+                             xonxoff=True)
+        if not port.isOpen():
+            port.open()
+            port.isOpen()
+    except serial.SerialException as e:
+        port = None
+        print("SerialException:", e)
+        return False
+    return True
+
+
+def close():
+    global port
+    if port is not None:
+        port.close()
+        port = None
+
+
+# Read size bytes of data
+# The device escapes XON, XOFF and DLE in its data as DLE followed by the byte XOR 0x20,
+# because the serial driver consumes all XON and XOFF characters for flow control.
+#
+def read(size=1):
+    data = bytearray()
+    escaped = False
+
+    while len(data) < size:
+        for c in port.read(size - len(data)):
+            if escaped:
+                data.append(c ^ 0x20)
+                escaped = False
+            elif c == DLE:
+                escaped = True
+            else:
+                data.append(c)
+
+    return bytes(data)
+
+
+def write(data):
+    return port.write(data)
+
+
+# CRC-8 with polynomial x^8 + x^2 + x + 1, the same as _crc8_ccitt_update() of avr-libc
+#
+def crc8(data, crc=ACTIONCRC):
+    for c in data:
+        crc ^= c
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+# Translate an action_type tuple into an action record, ending with its CRC
+#
+def pack_action(action):
+    b = struct.pack("BBBBBBBBBB", action.valid, ord(action.major), action.minor, action.dd, action.mm, action.yy,
+                    action.wd, action.hh, action.mn, action.cmd)
+    return b + bytes([crc8(b)])
+
+
+# Start the timer
+# Send:     'A'
+# Receive:  '0' or '1'
+#
+def start_timer():
+    write(b"A")
+    r = read(1)
+    return ord(r[0:1])
+
+
+# Stop the timer
+# Send:     'B'
+# Receive:  '0' or '1'
+#
+def stop_timer():
+    write(b"B")
+    r = read(1)
+    return ord(r[0:1])
+
+
+# Read date and time from the device
+# Send:     'C'
+# Receive:  7 bytes - dd, mm, yy, weekday, hh, mm, ss
+#
+def get_datetime():
+    write(b"C")
+    b = read(7)
+    dd = ord(b[0:1])
+    mm = ord(b[1:2])
+    yy = ord(b[2:3])
+    wd = ord(b[3:4])
+    hh = ord(b[4:5])
+    mn = ord(b[5:6])
+    ss = ord(b[6:7])
+
+    date = datetime.date(2000 + yy, mm, dd)
+    time = datetime.time(hh, mn, ss)
+
+    return datetime_info_type(date, time, wd)
+
+
+# Set data and time on the device
+# Send:     'D'
+#           7 bytes: dd, mm, yy, weekday, hh, mm, ss
+# Receive:  '0' or '1'
+#
+def set_datetime():
+    now = datetime.datetime.now()
+
+    b = bytearray()
+
+    b.append(now.day)
+    b.append(now.month)
+    b.append(now.year - 2000)
+    b.append(now.isoweekday())  # monday = 1
+    b.append(now.hour)
+    b.append(now.minute)
+    b.append(now.second)
+
+    write(b"D")
+    write(b)
+
+    r = read(1)
+
+    return ord(r[0:1])
+
+
+# Echo a sequence number together with the millisecond clock of the device
+# Send:     'V'
+#           1 byte - sequence number
+# Receive:  3 bytes - sequence number, millisecond clock (16-bit, wraps around every 65.5 seconds)
+#
+def echo(seq):
+    write(struct.pack("<cB", b"V", seq & 0xFF))
+    b = read(3)
+
+    return struct.unpack("<BH", b)
+
+
+# Relate the millisecond clock of the device to the clock of the computer
+# The echo exchange with the shortest round trip is used, as it was delayed least by the serial
+# driver. The device read its clock halfway the round trip (+/- half a byte at 9600 baud).
+# Returns: computer time (seconds since the epoch), device millisecond clock at that time, round trip (seconds)
+#
+def clock_reference(exchanges=8):
+    best = None
+
+    for seq in range(exchanges):
+        t0 = time.time()
+        _, millis = echo(seq)
+        t1 = time.time()
+        if best is None or t1 - t0 < best[2]:
+            best = ((t0 + t1) / 2, millis, t1 - t0)
+
+    return best
+
+
+# Convert a device millisecond clock value to computer time using a clock_reference()
+#
+def device_to_computer_time(reference, millis):
+    host, ref_millis, _ = reference
+    delta = (millis - ref_millis) & 0xFFFF
+    if delta >= 0x8000:
+        delta -= 0x10000
+
+    return host + delta / 1000
+
+
+# Synchronize the device clock with the computer
+# The latency of the serial link is measured first, then the device is told to set its clock
+# at the start of a whole second, at a moment given in its own millisecond clock.
+# Send:     'W'
+#           7 bytes: dd, mm, yy, weekday, hh, mm, ss
+#           2 bytes: device millisecond clock at which the clock must be set
+# Receive:  '0' or '1'
+# Returns: the remaining offset in ms of the device clock (see get_clock_offset()), or None on error
+#
+def sync_datetime(exchanges=8):
+    reference = clock_reference(exchanges)
+    host, millis, rtt = reference
+
+    # leave time to transmit the request, and as the device waits less than 900 ms
+    # for the moment to set its clock first wait here until shortly before it
+    lead = 0.05 + rtt
+    at = int(time.time() + lead) + 1
+    if at - time.time() > lead + 0.2:
+        time.sleep(at - time.time() - lead - 0.1)
+    at = datetime.datetime.fromtimestamp(at)
+    at_millis = (millis + round((at.timestamp() - host) * 1000)) & 0xFFFF
+
+    b = bytearray()
+
+    b.append(at.day)
+    b.append(at.month)
+    b.append(at.year - 2000)
+    b.append(at.isoweekday())  # monday = 1
+    b.append(at.hour)
+    b.append(at.minute)
+    b.append(at.second)
+    b += struct.pack("<H", at_millis)
+
+    write(b"W")
+    write(b)
+
+    if read(1) != b"1":
+        return None
+
+    return get_clock_offset(exchanges)
+
+
+# Measure the offset of the device clock to the clock of the computer
+# The device waits for its clock to start a new second and reports the time and its
+# millisecond clock at that moment.
+# Send:     'X'
+# Receive:  9 bytes - device millisecond clock (16-bit), dd, mm, yy, weekday, hh, mm, ss (all 0 on error)
+# Returns: offset in ms, positive if the device clock is ahead, or None if the device clock is not running
+#
+def get_clock_offset(exchanges=8):
+    reference = clock_reference(exchanges)
+
+    write(b"X")
+    b = read(9)
+
+    millis, dd, mm, yy, wd, hh, mn, ss = struct.unpack("<H7B", b)
+
+    if dd == 0:
+        return None
+
+    device_time = datetime.datetime(2000 + yy, mm, dd, hh, mn, ss).timestamp()
+
+    return (device_time - device_to_computer_time(reference, millis)) * 1000
+
+
+# Read an action from the timer device
+# Send:     'E'
+#           2 byte integer for action number
+# Receive:  11 bytes - valid, (char)major, minor, dd, mm, yy, wd, hh, mm, cmd, crc
+#           translated into an action_type tuple (without the crc)
+#
+def get_action(index):
+    write(b"E")
+
+    # < = little-endian, H = unsigned short (2 bytes)
+
+    b = struct.pack("<H", index)
+    write(b)
+
+    r = read(const.SIZEOFACTION)
+
+    # Unpack binary data, B = unsigned char, c = char, x = skipped byte
+
+    return action_type._make(struct.unpack("BcBBBBBBBBx", r))
+
+
+# Read a range of actions from the timer device
+# Send:     'P'
+#           2 byte integer for the first action number
+#           2 byte integer for the number of actions (the device sends at most STREAMBLOCK)
+# Receive:  11 bytes per action (see get_action)
+#           translated into a list of action_type tuples
+#
+def get_actions(index, count):
+    count = min(count, const.STREAMBLOCK)
+
+    write(b"P")
+
+    # < = little-endian, H = unsigned short (2 bytes)
+
+    b = struct.pack("<HH", index, count)
+    write(b)
+
+    r = read(const.SIZEOFACTION * count)
+
+    # Unpack binary data, B = unsigned char, c = char, x = skipped byte
+
+    return [action_type._make(a) for a in struct.iter_unpack("BcBBBBBBBBx", r)]
+
+
+# Send an action to the timer device
+# Send:     'F'
+#           11 bytes - valid, (char)major, minor, dd, mm, yy, wd, hh, mm, cmd (all read from an action_type tuple), crc
+# Receive:  '0' or '1' ('0' also if the crc does not match, like when the action was garbled on the serial line)
+#
+def set_action(index, action):
+    write(b"F")
+
+    # < = little-endian, H = unsigned short (2 bytes)
+
+    b = struct.pack("<H", index)
+    write(b)
+
+    write(pack_action(action))
+
+    r = read(1)
+
+    return ord(r[0:1])
+
+
+# Send a number of consecutive actions to the timer device
+# The requests are streamed without waiting for the replies, the serial driver pauses
+# when the device signals its receive buffer is getting full (XOFF).
+# Send:     'F' + index + 11 bytes per action (see set_action)
+# Receive:  '0' or '1' per action
+#
+def set_actions(index, actions):
+    b = bytearray()
+
+    for i, action in enumerate(actions):
+        b += b"F"
+        b += struct.pack("<H", index + i)
+        b += pack_action(action)
+    write(b)
+
+    r = read(len(actions))
+
+    return r.count(b"1") == len(actions)
+
+
+# Activate the schedule written with set_action(s)
+# The device keeps executing the old schedule until the new one is activated.
+# Send:     'Q'
+# Receive:  '0' or '1'
+#
+def activate_schedule():
+    write(b"Q")
+    r = read(1)
+    return ord(r[0:1])
+
+
+# Read the execution log, oldest entry first, in pages of at most STREAMBLOCK entries
+# Send:     'R'
+#           2 byte integer for the first entry (0 = oldest)
+#           2 byte integer for the number of entries (the device sends at most STREAMBLOCK)
+# Receive:  2 byte integer for the number of entries in the log
+#           8 bytes per entry - dd, mm, yy, hh, mm, ss, unit, command (bit 7) + lateness in seconds (bits 0-6)
+#           '0' or '1' ('0' if an entry could not be read)
+# Returns: a list of log_entry_type tuples (entries which could not be read are skipped),
+#          and False if the device reported an error, else True
+#
+def get_log():
+    log = []
+    ok = True
+    index = 0
+
+    while True:
+        write(b"R")
+
+        # < = little-endian, H = unsigned short (2 bytes)
+
+        write(struct.pack("<HH", index, const.STREAMBLOCK))
+
+        (count,) = struct.unpack("<H", read(2))
+        n = max(0, min(const.STREAMBLOCK, count - index))
+        b = read(8 * n)
+
+        if read(1) != b"1":
+            ok = False
+
+        for dd, mm, yy, hh, mn, ss, unit, cmd in struct.iter_unpack("BBBBBBBB", b):
+            try:
+                timestamp = datetime.datetime(2000 + yy, mm, dd, hh, mn, ss)
+            except ValueError:
+                continue
+            log.append(log_entry_type(timestamp, chr(ord("A") + (unit >> 4)), (unit & 0x0F) + 1, cmd >> 7, cmd & 0x7F))
+
+        index += n
+        if n == 0 or index >= count:
+            return log, ok
+
+
+# Read the execution time per profiled function (only when the firmware was built with -DPROFILE)
+# Send:     'S'
+# Receive:  4 bytes - number of entries, CPU cycles per tick, ticks of the profiling overhead
+#           14 bytes per entry - calls, total, minimum and maximum ticks
+#           translated into (cycles per tick, overhead, list of profile_entry_type tuples)
+#
+def get_profile():
+    write(b"S")
+
+    # < = little-endian, B = unsigned char, H = unsigned short (2 bytes), I = unsigned int (4 bytes)
+
+    count, prescaler, overhead = struct.unpack("<BBH", read(4))
+    b = read(14 * count)
+
+    return prescaler, overhead, [profile_entry_type._make(e) for e in struct.iter_unpack("<HIII", b)]
+
+
+# Read the SRAM usage
+# Send:     'T'
+# Receive:  8 bytes - static variables, deepest stack usage, free space now, never used space (all in bytes)
+#
+def get_memory():
+    write(b"T")
+    b = read(8)
+
+    return memory_type._make(struct.unpack("<HHHH", b))
+
+
+# Read the last command sent to every unit
+# Send:     'U'
+# Receive:  32 bytes - bitmap with one bit per unit, bit (major - 'A') * 16 + minor - 1, set = on
+#           translated into a dict with (major, minor) as key and the command (0 or 1) as value
+#
+def get_unit_states():
+    write(b"U")
+    b = read(32)
+
+    return {(ord("A") + unit // 16, unit % 16 + 1): (b[unit // 8] >> (unit % 8)) & 1 for unit in range(256)}
+
+
+# Read the lateness histogram of the executed actions
+# Send:     'Y'
+#           1 byte - 1 = clear the histogram after reading it, 0 = keep it
+# Receive:  4 bytes - largest lateness (ms)
+#           LATENESSBUCKETS x 2 bytes - number of actions per LATENESSWIDTH seconds of lateness, the last one includes all later
+#
+def get_lateness(clear=False):
+    write(struct.pack("<cB", b"Y", 1 if clear else 0))
+    b = read(4 + 2 * const.LATENESSBUCKETS)
+
+    v = struct.unpack("<I{}H".format(const.LATENESSBUCKETS), b)
+
+    return lateness_type(v[0], list(v[1:]))
+
+
+# Switch a unit on or off
+# Send:     'G'
+#           3 bytes - major, minor, cmd
+# Receive:  '0' or '1'
+#
+def switch(major, minor, command):
+    write(b"G")
+
+    b = struct.pack("BBB", major, minor, command)
+    write(b)
+
+    r = read(1)
+
+    return ord(r[0:1])
+
+
+# Switch a number of units on or off, in a single RF burst as far as the airtime budget allows
+# The device replies once the units are queued for transmission, so it may wait for earlier signals
+# Send:     'L'
+#           1 byte - number of units (max SCENESIZE)
+#           3 bytes per unit - major, minor, cmd
+# Receive:  '0' or '1'
+#
+def switch_scene(units):
+    write(b"L")
+
+    b = bytearray()
+    b.append(len(units))
+    for major, minor, command in units:
+        b += struct.pack("BBB", major, minor, command)
+    write(b)
+
+    r = read(1)
+
+    return ord(r[0:1])
+
+
+# Read device info
+# Send:     'H'
+# Receive:  37 bytes
+#
+def get_info():
+    write(b"H")
+    b = read(37)
+
+    hw_version = b[0:3].decode().lstrip()
+    sw_version = b[3:6].decode().lstrip()
+    memory_size_string = b[6:13].decode()
+    memory_size = 0 if len(memory_size_string) == 0 else int(memory_size_string)
+    action_count_string = b[13:18].decode()
+    action_count = 0 if len(action_count_string) == 0 else int(action_count_string)
+    max_actions_string = b[18:23].decode()
+    max_actions = 0 if len(max_actions_string) == 0 else int(max_actions_string)
+    generation = int(b[23:28].decode())
+    layout_version = int(b[28:31].decode())
+    schedule_intact = b[31:32] == b"1"
+    schedule_crc = int(b[32:37].decode())
+
+    return device_info_type(hw_version, sw_version, memory_size, action_count, max_actions, generation,
+                            layout_version, schedule_intact, schedule_crc)
+
+
+# Read performance counters
+# Send:     'M'
+# Receive:  27 bytes - worst-case task duration (ms), max number of queued RF signals,
+#           number of RF frames sent, total airtime (ms), airtime saved by the unit configuration (ms),
+#           number of received bytes lost, EEPROM cache hits and misses, number of corrupt actions read,
+#           index of the last corrupt action, complete schedule checks by the scrubber, its worst-case duration (ms)
+#
+def get_statistics():
+    write(b"M")
+    b = read(27)
+
+    # Unpack binary data, < = little-endian, H = unsigned short, B = unsigned char, I = unsigned int, i = int
+
+    return statistics_type._make(struct.unpack("<HBHIiHHHHHHH", b))
+
+
+# Read the unit configuration table
+# Send:     'N'
+# Receive:  UNITCONFIGSIZE x 4 bytes - unit, repeats, turn-on delay (ms), gap (ms)
+#           translated into a list of unit_config_type tuples for the entries in use
+#
+def get_unit_config():
+    write(b"N")
+    b = read(const.UNITCONFIGSIZE * 4)
+
+    config = []
+    for unit, repeats, turn_on, gap in struct.iter_unpack("BBBB", b):
+        if repeats != 0:
+            config.append(unit_config_type(chr(ord("A") + (unit >> 4)), (unit & 0x0F) + 1, repeats, turn_on, gap))
+    return config
+
+
+# Write the unit configuration table
+# Send:     'O'
+#           UNITCONFIGSIZE x 4 bytes - unit, repeats, turn-on delay (ms), gap (ms) (from a list of unit_config_type)
+# Receive:  '0' or '1'
+#
+def set_unit_config(config):
+    write(b"O")
+
+    b = bytearray()
+    for entry in config[:const.UNITCONFIGSIZE]:
+        unit = ((ord(entry.major) - ord("A")) << 4) | (entry.minor - 1)
+        b += struct.pack("BBBB", unit, entry.repeats, entry.turn_on, entry.gap)
+    b += bytes(const.UNITCONFIGSIZE * 4 - len(b))  # unused entries have repeats = 0
+    write(b)
+
+    r = read(1)
+
+    return ord(r[0:1])
+
+
+# Write device info
+# Send:     'I'
+#           8 bytes - hardware version, memory type (for I2C EEPROM the high nibble holds the number
+#           of chips - 1), total memory size in bytes, magic number
+#
+def set_info(hw_version, memory_type, memory_size):
+    # to avoid accidental use ...
+    if 1:
+        return
+
+    write(b"I")
+
+    b = struct.pack("<BB", hw_version, memory_type)
+    write(b)
+    b = struct.pack("<IH", memory_size, 0xABFE)
+    write(b)
+
+    # Note: no OK or Error response from device
+
+
+# Switch on trace events, which the device sends when its serial port is idle
+# Send:     'J'
+# Receive:  '0' or '1', followed by binary trace events (decoded by tracer.py)
+#
+def set_verbose():
+    write(b"J")
+
+    b = read(1)
+
+    return ord(b[0:1])
+
+
+# Force a reset (currently waits for the user the press the reset button
+# Send:     'K'
+#
+def reset():
+    write(b"K")
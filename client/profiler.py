@@ -0,0 +1,62 @@
+""" Show the execution time of the profiled firmware functions.
+
+The firmware must be built with -DPROFILE, see timer/profile.c. This program
+reads the profile records from the device and prints per function the number
+of calls and the minimum, average and maximum time in CPU cycles and
+microseconds. The cost of the measurement itself is subtracted.
+
+No hardware is needed when the firmware runs in simavr: start simavr with its
+uart_pty bridge and pass the pseudo terminal it creates (e.g. /tmp/simavr-uart0)
+as comport.
+
+Usage: python profiler.py comport
+"""
+
+import sys
+
+import device
+
+F_CPU = 20000000  # CPU clock of the device in Hz
+
+# function names in the order of the id's in timer/profile.h
+#
+FUNCTIONS = ["checkActions", "executeActions", "i2cReadData", "bcd2int", "sendSignal"]
+
+
+def report(prescaler, overhead, entries):
+    print("{:<16} {:>7} {:>12} {:>12} {:>12} {:>10}".format("function", "calls", "min cycles", "avg cycles",
+                                                        "max cycles", "max us"))
+    for i, entry in enumerate(entries):
+        name = FUNCTIONS[i] if i < len(FUNCTIONS) else "id {}".format(i)
+        if entry.calls == 0:
+            print("{:<16} {:>7}".format(name, 0))
+            continue
+        low = max(entry.min - overhead, 0) * prescaler
+        avg = max(entry.total / entry.calls - overhead, 0) * prescaler
+        high = max(entry.max - overhead, 0) * prescaler
+        print("{:<16} {:>7} {:>12} {:>12.0f} {:>12} {:>10.1f}".format(name, entry.calls, low, avg, high,
+                                                                 high * 1000000 / F_CPU))
+
+
+def main(argv):
+    if len(argv) != 2:
+        print(__doc__)
+        return 1
+
+    if device.connect(argv[1]) is False:
+        return 1
+
+    try:
+        prescaler, overhead, entries = device.get_profile()
+        if not entries:
+            print("the firmware was not built with -DPROFILE")
+            return 1
+        report(prescaler, overhead, entries)
+    finally:
+        device.close()
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
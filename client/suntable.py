@@ -0,0 +1,95 @@
+""" Generate the sunrise and sunset table of the timer.
+
+The timer does not calculate sun times itself. This program calculates them
+for every day of the year for the location where the timer is used, and
+writes them as a table in flash memory to timer/suntable.c. Rebuild the
+firmware after running it.
+
+Times are in minutes since 00:00 local standard (winter) time; the timer adds
+an hour during summer time. The calculation uses the NOAA approximation of
+the solar position and is accurate to about a minute.
+
+Usage: python suntable.py [latitude longitude utc-offset-in-hours [output]]
+       defaults: 52.09 5.12 1 (Utrecht), ../timer/suntable.c
+"""
+
+import datetime
+import math
+import os
+import sys
+
+LATITUDE = 52.09  # degrees, north is positive
+LONGITUDE = 5.12  # degrees, east is positive
+UTCOFFSET = 1  # hours between local standard time and UTC
+
+OUTPUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "timer", "suntable.c")
+
+REFERENCEYEAR = 2024  # a leap year, so the table has an entry for 29 February
+
+
+# Return sunrise and sunset on date in minutes since 00:00 UTC
+#
+def sun_times(date, latitude, longitude):
+    g = 2 * math.pi / 365 * (date.timetuple().tm_yday - 1)  # fractional year at noon
+
+    eqtime = 229.18 * (0.000075 + 0.001868 * math.cos(g) - 0.032077 * math.sin(g)
+                       - 0.014615 * math.cos(2 * g) - 0.040849 * math.sin(2 * g))
+    decl = (0.006918 - 0.399912 * math.cos(g) + 0.070257 * math.sin(g) - 0.006758 * math.cos(2 * g)
+            + 0.000907 * math.sin(2 * g) - 0.002697 * math.cos(3 * g) + 0.00148 * math.sin(3 * g))
+
+    lat = math.radians(latitude)
+    cos_ha = math.cos(math.radians(90.833)) / (math.cos(lat) * math.cos(decl)) - math.tan(lat) * math.tan(decl)
+    ha = math.degrees(math.acos(max(-1.0, min(1.0, cos_ha))))  # the sun never sets or rises: clip
+
+    sunrise = 720 - 4 * (longitude + ha) - eqtime
+    sunset = 720 - 4 * (longitude - ha) - eqtime
+
+    return sunrise, sunset
+
+
+def generate(latitude, longitude, utcoffset):
+    lines = []
+    date = datetime.date(REFERENCEYEAR, 1, 1)
+
+    while date.year == REFERENCEYEAR:
+        sunrise, sunset = sun_times(date, latitude, longitude)
+        rise = int(round(sunrise + utcoffset * 60)) % (24 * 60)
+        set_ = int(round(sunset + utcoffset * 60)) % (24 * 60)
+        lines.append("\t{{ {:4d}, {:4d} }},\t\t// {:02d}-{:02d}".format(rise, set_, date.day, date.month))
+        date += datetime.timedelta(days=1)
+
+    lines[-1] = lines[-1].replace("},", "} ", 1)
+
+    return ("/*\tsuntable.c\n"
+            " *\n"
+            " *\tSunrise and sunset per day of the year, in minutes since 00:00 local standard time.\n"
+            " *\n"
+            " *\tGenerated by client/suntable.py for latitude {}, longitude {}, UTC{:+d} - do not edit.\n"
+            " *\n"
+            " */\n"
+            "#include <avr/pgmspace.h>\n"
+            "#include \"sun.h\"\n"
+            "\n"
+            "const SUNTIMES sunTable[SUNTABLESIZE] PROGMEM = {{\n"
+            "{}\n"
+            "}};\n").format(latitude, longitude, utcoffset, "\n".join(lines))
+
+
+def main(argv):
+    if len(argv) not in (1, 4, 5):
+        print(__doc__)
+        return 1
+
+    latitude, longitude, utcoffset = LATITUDE, LONGITUDE, UTCOFFSET
+    if len(argv) >= 4:
+        latitude, longitude, utcoffset = float(argv[1]), float(argv[2]), int(argv[3])
+    output = argv[4] if len(argv) == 5 else OUTPUT
+
+    with open(output, "w", newline="\r\n") as f:  # the firmware sources use CRLF line endings
+        f.write(generate(latitude, longitude, utcoffset))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,63 @@
+""" Show the trace events of the timer.
+
+After set_verbose() the device sends binary trace events when its serial port
+is idle. Every event is an id byte followed by its arguments, see timer/trace.h.
+This program switches tracing on and prints the decoded events until it is
+interrupted.
+
+Usage: python tracer.py comport
+"""
+
+import struct
+import sys
+
+import device
+
+# event id: (name, struct format of the arguments, format string for the unpacked arguments)
+#
+EVENTS = {
+    0x80: ("lost", "<B", "{} events lost"),
+    0x81: ("verbose", "", "tracing on"),
+    0x82: ("position", "<H", "next action is {}"),
+    0x83: ("check", "<BBBBBBB", "check on {:02d}-{:02d}-{:02d} ({}) {:02d}:{:02d}:{:02d}"),
+    0x84: ("execute", "<hh", "execute actions between {} (incl) and {} (excl)"),
+    0x85: ("due", "<Hh", "action {} due at {}"),
+    0x86: ("action", "<BBB", "queue {:c}-{:02d}={}"),
+    0x87: ("corrupt", "<H", "action {} is corrupt, skipped"),
+}
+
+
+def decode():
+    while True:
+        (event,) = device.read(1)
+        if event not in EVENTS:
+            print("unknown event 0x{:02X}".format(event))
+            continue
+        name, fmt, text = EVENTS[event]
+        args = struct.unpack(fmt, device.read(struct.calcsize(fmt))) if fmt else ()
+        print(text.format(*args))
+
+
+def main(argv):
+    if len(argv) != 2:
+        print(__doc__)
+        return 1
+
+    if device.connect(argv[1]) is False:
+        return 1
+
+    try:
+        if device.set_verbose() != ord("1"):
+            print("device did not accept the verbose request")
+            return 1
+        decode()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        device.close()
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -1,9 +1,10 @@
-import ui.editor
-import ui.model
-from ui.comport import Comport
-from ui.editor import Editor
-from ui.info import Info
-from ui.loadui import loadUi
-from ui.mainwindow import MainWindow
-from ui.manual import Manual
-from ui.progressbar import ProgressBar
+import ui.editor
+import ui.model
+from ui.comport import Comport
+from ui.editor import Editor
+from ui.info import Info
+from ui.loadui import loadUi
+from ui.log import Log
+from ui.mainwindow import MainWindow
+from ui.manual import Manual
+from ui.progressbar import ProgressBar
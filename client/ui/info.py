@@ -1,34 +1,64 @@
-from PyQt5.QtCore import Qt, pyqtSlot
-from PyQt5.QtWidgets import QDialog
-
-import const
-import device
-import ui
-
-
-class Info(QDialog):
-    def __init__(self, parent=None):
-        super().__init__(parent)
-
-        ui.loadUi(__file__, self)
-
-        self.setWindowFlags(Qt.Window | Qt.WindowTitleHint | Qt.CustomizeWindowHint)
-        self.parent = parent
-
-    def refresh(self):
-        device_info = device.get_info()
-        device_datetime = device.get_datetime()
-
-        self.txtHwVersion.setText(device_info.hw_version)
-        self.txtSwVersion.setText(device_info.sw_version)
-        self.txtMemorySize.setText(str(device_info.memory_size))
-        self.txtActionCount.setText(str(device_info.action_count))
-        self.txtMaxActions.setText(str(device_info.memory_size // const.SIZEOFACTION))
-        self.txtDate.setText(str(device_datetime.date))
-        self.txtTime.setText(str(device_datetime.time))
-        self.txtWeekday.setText(str(device_datetime.weekday))
-        self.lblWeekdayName.setText(const.WEEKDAYNAMES[device_datetime.weekday - 1])
-
-    @pyqtSlot()
-    def on_cmdBack_clicked(self):
-        self.parent.show_page1()
+from PyQt5.QtCore import Qt, pyqtSlot
+from PyQt5.QtWidgets import QDialog
+
+import const
+import device
+import ui
+
+
+class Info(QDialog):
+    def __init__(self, parent=None):
+        super().__init__(parent)
+
+        ui.loadUi(__file__, self)
+
+        self.setWindowFlags(Qt.Window | Qt.WindowTitleHint | Qt.CustomizeWindowHint)
+        self.parent = parent
+
+    def refresh(self):
+        device_info = device.get_info()
+        device_datetime = device.get_datetime()
+        device_statistics = device.get_statistics()
+        device_memory = device.get_memory()
+        device_lateness = device.get_lateness()
+
+        self.txtHwVersion.setText(device_info.hw_version)
+        self.txtSwVersion.setText(device_info.sw_version)
+        self.txtMemorySize.setText(str(device_info.memory_size))
+        self.txtActionCount.setText("{}{}".format(device_info.action_count,
+                                                  "" if device_info.schedule_intact else " (CRC ERROR)"))
+        self.txtMaxActions.setText(str(device_info.max_actions))
+        self.txtDate.setText(str(device_datetime.date))
+        self.txtTime.setText(str(device_datetime.time))
+        self.txtWeekday.setText(str(device_datetime.weekday))
+        self.lblWeekdayName.setText(const.WEEKDAYNAMES[device_datetime.weekday - 1])
+        self.txtLoopLatency.setText(str(device_statistics.loop_latency_max))
+        self.txtRfQueue.setText(str(device_statistics.rf_queue_max))
+        self.txtRfAirtime.setText("{:.1f}".format(device_statistics.rf_airtime / 1000))
+        self.txtRfAirtimeSaved.setText("{:.1f}".format(device_statistics.rf_airtime_saved / 1000))
+        self.txtRxOverflows.setText(str(device_statistics.rx_overflows))
+        self.txtCache.setText("{} / {}".format(device_statistics.cache_hits, device_statistics.cache_misses))
+        self.txtMemory.setText("{} / {} / {}".format(device_memory.static_size, device_memory.stack_max,
+                                                     device_memory.free_min))
+        self.txtLateness.setText(self.lateness_text(device_lateness))
+        self.txtScrub.setText("{}{} / {} / {} ms".format(
+            device_statistics.action_errors,
+            " (last {})".format(device_statistics.action_error_last) if device_statistics.action_errors else "",
+            device_statistics.scrub_passes, device_statistics.scrub_time_max))
+
+    # max followed by the non-empty buckets, e.g. "max 1.3 | 0: 52 1: 3 15+: 1"
+    #
+    @staticmethod
+    def lateness_text(lateness):
+        buckets = ["{}{}: {}".format(i * const.LATENESSWIDTH, "+" if i == len(lateness.count) - 1 else "", n)
+                   for i, n in enumerate(lateness.count) if n > 0]
+        return " | ".join(["max {:.1f}".format(lateness.max / 1000), " ".join(buckets)])
+
+    @pyqtSlot()
+    def on_cmdClearLateness_clicked(self):
+        device.get_lateness(clear=True)
+        self.refresh()
+
+    @pyqtSlot()
+    def on_cmdBack_clicked(self):
+        self.parent.show_page1()
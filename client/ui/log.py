@@ -0,0 +1,41 @@
+from PyQt5.QtCore import Qt, pyqtSlot
+from PyQt5.QtWidgets import QApplication, QDialog, QMessageBox, QTableWidgetItem
+
+import device
+import ui
+
+
+class Log(QDialog):
+    def __init__(self, parent=None):
+        super().__init__(parent)
+
+        ui.loadUi(__file__, self)
+
+        self.setWindowFlags(Qt.Window | Qt.WindowTitleHint | Qt.CustomizeWindowHint)
+        self.parent = parent
+
+    def refresh(self):
+        log, ok = device.get_log()
+
+        if not ok:
+            QMessageBox.warning(self, QApplication.applicationName(),
+                                "Not all log entries could be read from the device")
+
+        self.tblLog.setRowCount(len(log))
+
+        for row, entry in enumerate(reversed(log)):  # most recent entry on top
+            lateness = str(entry.lateness) if entry.lateness < 127 else ">127"
+            for column, text in enumerate([entry.timestamp.strftime("%d-%m-%y"), entry.timestamp.strftime("%H:%M:%S"),
+                                           "{}-{}".format(entry.major, entry.minor), "On" if entry.command else "Off",
+                                           lateness]):
+                self.tblLog.setItem(row, column, QTableWidgetItem(text))
+
+        self.tblLog.resizeColumnsToContents()
+
+    @pyqtSlot()
+    def on_cmdRefresh_clicked(self):
+        self.refresh()
+
+    @pyqtSlot()
+    def on_cmdBack_clicked(self):
+        self.parent.show_page1()
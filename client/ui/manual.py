@@ -1,37 +1,54 @@
-from PyQt5.QtCore import Qt, pyqtSlot
-from PyQt5.QtWidgets import QDialog
-
-import device
-import const
-import ui
-
-
-class Manual(QDialog):
-    def __init__(self, parent=None):
-        super().__init__(parent)
-
-        ui.loadUi(__file__, self)
-
-        self.setWindowFlags(Qt.Window | Qt.WindowTitleHint | Qt.CustomizeWindowHint)
-        self.parent = parent
-
-        self.lstMajor.addItems(const.MAJORNAMES)
-        self.lstMinor.addItems(const.MINORNAMES)
-        self.lstCommand.addItems(const.COMMANDNAMES)
-
-        self.lstMajor.setCurrentRow(0)
-        self.lstMinor.setCurrentRow(0)
-        self.lstCommand.setCurrentRow(0)
-
-        self.cmdExecute.setFocus(True)
-
-    @pyqtSlot()
-    def on_cmdExecute_clicked(self):
-        major = ord(self.lstMajor.currentItem().text())
-        minor = int(self.lstMinor.currentItem().text())
-        command = 1 if self.lstCommand.currentItem().text() == "On" else 0
-        device.switch(major, minor, command)
-
-    @pyqtSlot()
-    def on_cmdBack_clicked(self):
-        self.parent.show_page1()
+from PyQt5.QtCore import Qt, pyqtSlot
+from PyQt5.QtWidgets import QDialog
+
+import device
+import const
+import ui
+
+
+class Manual(QDialog):
+    def __init__(self, parent=None):
+        super().__init__(parent)
+
+        ui.loadUi(__file__, self)
+
+        self.setWindowFlags(Qt.Window | Qt.WindowTitleHint | Qt.CustomizeWindowHint)
+        self.parent = parent
+
+        self.lstMajor.addItems(const.MAJORNAMES)
+        self.lstMinor.addItems(const.MINORNAMES)
+        self.lstCommand.addItems(const.COMMANDNAMES)
+
+        self.lstMajor.setCurrentRow(0)
+        self.lstMinor.setCurrentRow(0)
+        self.lstCommand.setCurrentRow(0)
+
+        self.cmdExecute.setFocus(True)
+
+    def refresh(self):
+        states = device.get_unit_states()
+        on = ["{}{}".format(chr(major), minor) for (major, minor), command in sorted(states.items()) if command == 1]
+        self.lblStates.setText("On: " + " ".join(on) if on else "All units are off")
+
+    @pyqtSlot()
+    def on_cmdExecute_clicked(self):
+        command = 1 if self.lstCommand.currentItem().text() == "On" else 0
+        units = [(ord(major.text()), int(minor.text()), command)
+                 for major in self.lstMajor.selectedItems() for minor in self.lstMinor.selectedItems()]
+        self.switch(units)
+
+    @pyqtSlot()
+    def on_cmdAllOff_clicked(self):
+        units = [(ord(major), int(minor), 0) for major in const.MAJORNAMES for minor in const.MINORNAMES]
+        self.switch(units)
+
+    # send all units as one or more scenes, the device transmits them in as few RF bursts as its airtime budget allows
+    #
+    def switch(self, units):
+        for i in range(0, len(units), const.SCENESIZE):
+            device.switch_scene(units[i:i + const.SCENESIZE])
+        self.refresh()
+
+    @pyqtSlot()
+    def on_cmdBack_clicked(self):
+        self.parent.show_page1()
@@ -1,165 +1,254 @@
-import json
-
-from PyQt5.QtCore import QAbstractTableModel, QDate, QTime, QVariant, Qt
-
-import const
-import device
-import ui
-
-
-class MyModel(QAbstractTableModel):
-    def __init__(self, rows=0, parent=None):
-        super().__init__(parent)
-
-        self.parent = parent
-        self.rows = rows
-        self.myList = [list([None] * 6) for _ in range(rows)]
-
-    def rowCount(self, parent, **kwargs):
-        return len(self.myList)
-
-    def columnCount(self, parent, **kwargs):
-        if len(self.myList) > 0:
-            return len(self.myList[0])
-        return 0
-
-    def data(self, index, role=Qt.DisplayRole):
-        if not index.isValid():
-            return None
-        elif role == Qt.TextAlignmentRole:
-            return QVariant(Qt.AlignCenter | Qt.AlignVCenter)
-        elif role == Qt.DisplayRole or role == Qt.EditRole:
-            value = self.myList[index.row()][index.column()]
-            return value
-        else:
-            return None
-
-    def flags(self, index):
-        return Qt.ItemIsEditable | QAbstractTableModel.flags(self, index)
-
-    def headerData(self, col, orientation, role):
-        if orientation == Qt.Horizontal and role == Qt.DisplayRole:
-            return ["Major", "Minor", "Date", "Weekday", "Time", "Command"][col]
-        return None
-
-    def setData(self, index, value, role=Qt.EditRole):
-        if isinstance(value, str) and value.strip() == "":
-            value = None
-        if role == Qt.EditRole:
-            self.myList[index.row()][index.column()] = value
-            self.dataChanged.emit(index, index)
-            return True
-        return False
-
-    def sort(self, col, order):
-        self.layoutAboutToBeChanged.emit()
-        self.myList = sorted(self.myList, key=lambda x: (x[col] is None, x[col]))
-        # self.myList = sorted(self.myList, key=operator.itemgetter(col))
-        if order == Qt.DescendingOrder:
-            self.myList.reverse()
-        self.layoutChanged.emit()
-
-    def clear(self):
-        self.myList = [list([None] * 6) for _ in range(self.rows)]
-
-    def save(self, filename="output.txt"):
-        def json_helper(obj):
-            if type(obj) == QDate:
-                return obj.toString("dd-MM-yyyy")
-            elif type(obj) == QTime:
-                return obj.toString("hh:mm")
-            else:
-                return TypeError
-
-        self.nullify()
-
-        with open(filename, "w") as f:
-            json.dump(self.myList, f, default=json_helper, indent=4)
-
-    def load(self, filename="output.txt"):
-        with open(filename, "r") as f:
-            self.myList = json.load(f)
-
-        self.nullify()
-
-        for row in self.myList:
-            if row[2] is not None:
-                row[2] = QDate().fromString(row[2], "dd-MM-yyyy")
-            if row[4] is not None:
-                row[4] = QTime.fromString(row[4], "hh:mm")
-
-    def read_from_device(self):
-        self.clear()
-        info = device.get_info()
-
-        progressbar = ui.ProgressBar("Read from device", self.parent)
-        progressbar.setMaximum(info.action_count)
-        progressbar.show()
-
-        for index in range(info.action_count):
-            action = device.get_action(index)
-
-            if action.valid == 1:
-                row = self.myList[index]
-                row[0] = action.major.decode("utf-8")
-                row[1] = str(action.minor)
-                row[2] = None if action.dd == 0 else QDate(action.yy + 2000, action.mm, action.dd)
-                row[3] = None if action.wd == 0 else const.WEEKDAYNAMES[action.wd - 1]
-                row[4] = QTime(action.hh, action.mn)
-                row[5] = "On" if action.cmd == 1 else "Off"
-
-            progressbar.incrementValue()
-
-        progressbar.close()
-
-    def write_to_device(self):
-        self.nullify()
-
-        sorted_list = sorted(self.myList, key=lambda x: (x[4] is None, x[4]))
-
-        progressbar = ui.ProgressBar("Write to device", self.parent)
-        progressbar.setMaximum(self.rows)
-        progressbar.show()
-
-        device.stop_timer()
-
-        count = 0
-        for row in sorted_list:
-            # major, minor, time and command must be filled
-            if row[0] is None or row[1] is None or row[4] is None or row[5] is None:
-                continue
-            else:
-                major = 0 if row[0] is None else row[0]
-                minor = 0 if row[1] is None else int(row[1])
-                dd = 0 if row[2] is None else row[2].day()
-                mm = 0 if row[2] is None else row[2].month()
-                yy = 0 if row[2] is None else row[2].year() - 2000
-                wd = 0 if row[3] is None else const.WEEKDAYNAMES.index(row[3]) + 1
-                hh = 0 if row[4] is None else row[4].hour()
-                mn = 0 if row[4] is None else row[4].minute()
-                cmd = 1 if row[5] == "On" else 0
-
-                action = device.action_type(1, major, minor, dd, mm, yy, wd, hh, mn, cmd)
-                device.set_action(count, action)
-
-                count += 1
-                progressbar.setValue(count)
-
-        empty_action = device.action_type(0, b"0", 0, 0, 0, 0, 0, 0, 0, 0)
-
-        for index in range(count, self.rows):
-            device.set_action(index, empty_action)
-            progressbar.setValue(index)
-
-        device.start_timer()
-        # device.reset()
-
-        progressbar.close()
-
-    # replace empty strings (left when clearing an entry) by None values
-    #
-    def nullify(self):
-        for r, row in enumerate(self.myList):
-            for c, col in enumerate(row):
-                if col == "":
-                    self.myList[r][c] = None
+import json
+import struct
+
+from PyQt5.QtCore import QAbstractTableModel, QDate, QTime, QVariant, Qt
+from PyQt5.QtWidgets import QApplication, QMessageBox
+
+import const
+import device
+import ui
+
+DAYZERO = QDate(2000, 1, 1)  # day number 0 of date range actions
+
+
+class MyModel(QAbstractTableModel):
+    def __init__(self, rows=0, parent=None):
+        super().__init__(parent)
+
+        self.parent = parent
+        self.rows = rows
+        self.myList = [list([None] * 9) for _ in range(rows)]
+
+        # copy of the schedule last read from the device, and the generation it belongs to
+        self.cache = None
+        self.cacheKey = None
+
+    def rowCount(self, parent, **kwargs):
+        return len(self.myList)
+
+    def columnCount(self, parent, **kwargs):
+        if len(self.myList) > 0:
+            return len(self.myList[0])
+        return 0
+
+    def data(self, index, role=Qt.DisplayRole):
+        if not index.isValid():
+            return None
+        elif role == Qt.TextAlignmentRole:
+            return QVariant(Qt.AlignCenter | Qt.AlignVCenter)
+        elif role == Qt.DisplayRole or role == Qt.EditRole:
+            value = self.myList[index.row()][index.column()]
+            return value
+        else:
+            return None
+
+    def flags(self, index):
+        return Qt.ItemIsEditable | QAbstractTableModel.flags(self, index)
+
+    def headerData(self, col, orientation, role):
+        if orientation == Qt.Horizontal and role == Qt.DisplayRole:
+            return ["Major", "Minor", "Date", "Until", "Weekday", "Time", "Sun", "Offset", "Command"][col]
+        return None
+
+    def setData(self, index, value, role=Qt.EditRole):
+        if isinstance(value, str) and value.strip() == "":
+            value = None
+        if role == Qt.EditRole:
+            self.myList[index.row()][index.column()] = value
+            self.dataChanged.emit(index, index)
+            return True
+        return False
+
+    def sort(self, col, order):
+        self.layoutAboutToBeChanged.emit()
+        self.myList = sorted(self.myList, key=lambda x: (x[col] is None, x[col]))
+        # self.myList = sorted(self.myList, key=operator.itemgetter(col))
+        if order == Qt.DescendingOrder:
+            self.myList.reverse()
+        self.layoutChanged.emit()
+
+    def clear(self):
+        self.myList = [list([None] * 9) for _ in range(self.rows)]
+
+    def save(self, filename="output.txt"):
+        def json_helper(obj):
+            if type(obj) == QDate:
+                return obj.toString("dd-MM-yyyy")
+            elif type(obj) == QTime:
+                return obj.toString("hh:mm")
+            else:
+                return TypeError
+
+        self.nullify()
+
+        with open(filename, "w") as f:
+            json.dump(self.myList, f, default=json_helper, indent=4)
+
+    def load(self, filename="output.txt"):
+        with open(filename, "r") as f:
+            self.myList = json.load(f)
+
+        self.nullify()
+
+        for row in self.myList:
+            if len(row) == 6:  # file saved before the until column was added
+                row.insert(3, None)
+            if len(row) == 7:  # file saved before the sun and offset columns were added
+                row[6:6] = [None, None]
+            if row[2] is not None:
+                row[2] = QDate().fromString(row[2], "dd-MM-yyyy")
+            if row[3] is not None:
+                row[3] = QDate().fromString(row[3], "dd-MM-yyyy")
+            if row[5] is not None:
+                row[5] = QTime.fromString(row[5], "hh:mm")
+
+    def read_from_device(self):
+        self.clear()
+        info = device.get_info()
+
+        # the schedule on the device has not changed since it was last read, so skip reading it again
+        # (the generation alone is not unique, another device can have a schedule with the same generation)
+
+        if self.cache is not None and self.cacheKey == (info.generation, info.schedule_crc):
+            self.myList = [list(row) for row in self.cache]
+            return
+
+        progressbar = ui.ProgressBar("Read from device", self.parent)
+        progressbar.setMaximum(info.action_count)
+        progressbar.show()
+
+        for start in range(0, info.action_count, const.STREAMBLOCK):
+            actions = device.get_actions(start, min(const.STREAMBLOCK, info.action_count - start))
+
+            for index, action in enumerate(actions, start):
+                if action.valid in (device.ACTIONDATE, device.ACTIONRANGE, device.ACTIONSUNRISE, device.ACTIONSUNSET):
+                    row = self.myList[index]
+                    row[0] = action.major.decode("utf-8")
+                    row[1] = str(action.minor)
+                    if action.valid == device.ACTIONRANGE:
+                        row[2] = DAYZERO.addDays(action.dd | action.mm << 8)
+                        row[3] = row[2].addDays(action.yy)
+                    else:
+                        row[2] = None if action.dd == 0 else QDate(action.yy + 2000, action.mm, action.dd)
+                    row[4] = None if action.wd == 0 else const.WEEKDAYNAMES[action.wd - 1]
+                    if action.valid in (device.ACTIONSUNRISE, device.ACTIONSUNSET):
+                        row[6] = const.SUNNAMES[action.valid - device.ACTIONSUNRISE]
+                        row[7] = struct.unpack("<h", bytes([action.hh, action.mn]))[0]
+                    else:
+                        row[5] = QTime(action.hh, action.mn)
+                    row[8] = "On" if action.cmd == 1 else "Off"
+
+            progressbar.setValue(start + len(actions))
+
+        progressbar.close()
+
+        self.cache = [list(row) for row in self.myList]
+        self.cacheKey = (info.generation, info.schedule_crc)
+
+    def write_to_device(self):
+        self.nullify()
+
+        # the timed actions are sorted on time, the sun relative actions must follow them
+
+        sorted_list = sorted(self.myList, key=lambda x: (x[6] is not None, x[5] is None, x[5]))
+
+        actions = []
+        rejected = []
+        for row in sorted_list:
+            # major, minor, time or sun and command must be filled
+            if row[0] is None or row[1] is None or (row[5] is None and row[6] is None) or row[8] is None:
+                continue
+            elif row[2] is None and row[3] is not None:
+                # an until date without a date would make the action run every day, so it is not written
+                rejected.append("{}-{}".format(row[0], row[1]))
+            else:
+                major = 0 if row[0] is None else row[0]
+                minor = 0 if row[1] is None else int(row[1])
+                wd = 0 if row[4] is None else const.WEEKDAYNAMES.index(row[4]) + 1
+                hh = 0 if row[5] is None else row[5].hour()
+                mn = 0 if row[5] is None else row[5].minute()
+                cmd = 1 if row[8] == "On" else 0
+
+                if row[6] is not None:
+                    # relative to sunrise or sunset, a date range is not possible (the action only runs on the date)
+                    valid = device.ACTIONSUNRISE + const.SUNNAMES.index(row[6])
+                    hh, mn = struct.pack("<h", 0 if row[7] is None else int(row[7]))
+                    dd = 0 if row[2] is None else row[2].day()
+                    mm = 0 if row[2] is None else row[2].month()
+                    yy = 0 if row[2] is None else row[2].year() - 2000
+
+                    actions.append(device.action_type(valid, major, minor, dd, mm, yy, wd, hh, mn, cmd))
+                elif row[2] is not None and row[3] is not None:
+                    # a date range, longer ranges are split over multiple actions
+                    first = DAYZERO.daysTo(min(row[2], row[3]))
+                    last = DAYZERO.daysTo(max(row[2], row[3]))
+                    while first <= last:
+                        days = min(last - first, device.RANGEDAYS)
+                        actions.append(device.action_type(device.ACTIONRANGE, major, minor, first & 0xFF, first >> 8,
+                                                          days, wd, hh, mn, cmd))
+                        first += days + 1
+                else:
+                    dd = 0 if row[2] is None else row[2].day()
+                    mm = 0 if row[2] is None else row[2].month()
+                    yy = 0 if row[2] is None else row[2].year() - 2000
+
+                    actions.append(device.action_type(device.ACTIONDATE, major, minor, dd, mm, yy, wd, hh, mn, cmd))
+
+        if rejected:
+            answer = QMessageBox.warning(self.parent, QApplication.applicationName(),
+                                         "{} action(s) have an Until date but no Date and will not be written "
+                                         "(units {}).".format(len(rejected), ", ".join(rejected)),
+                                         QMessageBox.Ok | QMessageBox.Cancel)
+            if answer != QMessageBox.Ok:
+                return
+
+        # date ranges can take more than one action, so the schedule may not fit in the device
+
+        if len(actions) > self.rows:
+            answer = QMessageBox.warning(self.parent, QApplication.applicationName(),
+                                         "The schedule needs {} actions but the device holds {}, the last {} will "
+                                         "not be written.".format(len(actions), self.rows, len(actions) - self.rows),
+                                         QMessageBox.Ok | QMessageBox.Cancel)
+            if answer != QMessageBox.Ok:
+                return
+            actions = actions[:self.rows]
+
+        empty_action = device.action_type(0, b"0", 0, 0, 0, 0, 0, 0, 0, 0)
+
+        actions += [empty_action] * (self.rows - len(actions))
+
+        progressbar = ui.ProgressBar("Write to device", self.parent)
+        progressbar.setMaximum(self.rows)
+        progressbar.show()
+
+        # stream the actions in blocks, so the progressbar can be updated in between
+        # after a failure the inactive bank holds a mix of old and new actions, so it must not be activated
+
+        for index in range(0, len(actions), const.STREAMBLOCK):
+            if not device.set_actions(index, actions[index:index + const.STREAMBLOCK]):
+                progressbar.close()
+                QMessageBox.critical(self.parent, QApplication.applicationName(),
+                                     "Writing actions {} to {} failed, the schedule on the device was not "
+                                     "changed.".format(index, min(index + const.STREAMBLOCK, len(actions)) - 1))
+                return
+            progressbar.setValue(index)
+
+        # the device switches to the new schedule at once, the timer was never stopped
+
+        result = device.activate_schedule()
+
+        self.cache = None
+
+        progressbar.close()
+
+        if result != ord("1"):
+            QMessageBox.critical(self.parent, QApplication.applicationName(),
+                                 "The device rejected the new schedule, the previous schedule is still active.")
+
+    # replace empty strings (left when clearing an entry) by None values
+    #
+    def nullify(self):
+        for r, row in enumerate(self.myList):
+            for c, col in enumerate(row):
+                if col == "":
+                    self.myList[r][c] = None
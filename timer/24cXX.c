@@ -0,0 +1,144 @@
+/*	24cXX.c
+ *
+ *	Routines for accessing one or more 24cXX I2C EEPROMs as one linear memory.
+ *
+ *	A read or write which crosses the boundary between two chips is split in
+ *	one transfer per chip. Writes are also split at page boundaries, as the
+ *	24cXX wraps around within the page when writing beyond its end.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include "define.h"
+#include "24cXX.h"
+
+#define chipDevice(a)	(ee24CXX | (uint8_t)(((a) / chipSize) << 1))
+
+static uint8_t	chips = 1;				// number of chips
+static uint32_t	chipSize = 8192;		// bytes per chip
+static uint32_t	readAddr;				// address of the next byte of a sequential read
+static uint32_t	readLimit;				// first address beyond the chip of a sequential read
+
+
+/*	Set the number of chips, and the total size of all chips in bytes.
+ *
+ */
+void ee24CXXInit(uint8_t n, uint32_t size)
+{
+	if (n == 0 || n > ee24CXXMAXCHIPS)
+		n = 1;
+
+	chips = n;
+	chipSize = size / n;
+}
+
+
+/*	Read "len" bytes starting at "addr" into "d".
+ *
+ *	Return: number of bytes read, which will equal "len", or -1 in case of error
+ *
+ */
+int ee24CXXReadData(uint32_t addr, int len, uint8_t *d)
+{
+	int	n, r = 0;
+
+	while (r < len) {
+		if (addr >= chips * chipSize)
+			return -1;
+
+		n = len - r;
+		if (chipSize - addr % chipSize < n)
+			n = chipSize - addr % chipSize;
+
+		if (i2cReadData(chipDevice(addr), 2, addr % chipSize, n, d + r) != n)
+			return -1;
+
+		addr += n;
+		r += n;
+	}
+	return r;
+}
+
+
+/*	Write "len" bytes from "d" starting at "addr".
+ *
+ *	Return: number of bytes written, which will equal "len", or -1 in case of error
+ *
+ */
+int ee24CXXWriteData(uint32_t addr, int len, uint8_t *d)
+{
+	int	n, r = 0;
+
+	while (r < len) {
+		if (addr >= chips * chipSize)
+			return -1;
+
+		n = len - r;
+		if (ee24CXXPAGESIZE - addr % ee24CXXPAGESIZE < n)	// chip boundaries are also page boundaries
+			n = ee24CXXPAGESIZE - addr % ee24CXXPAGESIZE;
+
+		if (i2cWriteData(chipDevice(addr), 2, addr % chipSize, n, d + r) != n)
+			return -1;
+
+		addr += n;
+		r += n;
+	}
+	return r;
+}
+
+
+/*	Start a sequential read at "addr".
+ *
+ *	Return: 0, or -1 in case of error (the bus is then released)
+ *
+ */
+int ee24CXXReadOpen(uint32_t addr)
+{
+	if (addr >= chips * chipSize)
+		return -1;
+
+	readAddr = addr;
+	readLimit = (addr / chipSize + 1) * chipSize;
+
+	return i2cReadOpen(chipDevice(addr), 2, addr % chipSize);
+}
+
+
+/*	Read the next "len" bytes of a sequential read into "d". At the end of a
+ *	chip the read continues on the next chip.
+ *
+ *	Return: number of bytes read, which will equal "len", or -1 in case of
+ *			error (the bus is then released)
+ *
+ */
+int ee24CXXReadNext(int len, uint8_t *d)
+{
+	int	n, r = 0;
+
+	while (r < len) {
+		if (readAddr == readLimit) {
+			i2cReadClose();
+			if (ee24CXXReadOpen(readAddr) == -1)
+				return -1;
+		}
+
+		n = len - r;
+		if (readLimit - readAddr < n)
+			n = readLimit - readAddr;
+
+		if (i2cReadNext(n, d + r) != n)
+			return -1;
+
+		readAddr += n;
+		r += n;
+	}
+	return r;
+}
+
+
+/*	End a sequential read.
+ *
+ */
+void ee24CXXReadClose(void)
+{
+	i2cReadClose();
+}
@@ -1,21 +1,38 @@
-/*	24cXX.h
- *
- *	Defines for accessing a 24cXX I2C EEPROM.
- *
- *	2009	K.W.E. de Lange
- */
-#ifndef _24CXX_
-#define _24CXX_
-
-#include "i2c.h"
-
-#define ee24C65	0xA0	/* 24C65 I2C address */
-
-/*	The 24C65 a an 8Kb serial EEPROM. It is accessed via I2C, so the routines 
- *	to read- or write are actually disguised I2C access routines.
- *
- */
-#define ee24C65ReadData(a, l, d)	i2cReadData(ee24C65, 2,(uint16_t)a, l, d)
-#define	ee24C65WriteData(a, l, d)	i2cWriteData(ee24C65, 2,(uint16_t)a, l, d)
-
-#endif /* _24C65_ */
+/*	24cXX.h
+ *
+ *	Defines for accessing one or more 24cXX I2C EEPROMs.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _24CXX_
+#define _24CXX_
+
+#include "i2c.h"
+
+#define ee24CXX	0xA0	/* I2C address of the first 24cXX, the next ones use pins A0-A2 */
+
+#define ee24CXXMAXCHIPS	8		/* number of addresses selectable with pins A0-A2 */
+#define ee24CXXPAGESIZE	32		/* smallest write page of the 24C32 up to 24C512 */
+
+/*	The 24C32 up to 24C512 are 4 to 64 Kb serial EEPROMs with 2-byte addresses.
+ *	Up to 8 chips of the same type are presented as one linear memory, so the
+ *	addresses used here run from 0 to the total size of all chips.
+ *
+ */
+void ee24CXXInit(uint8_t chips, uint32_t size);
+
+int ee24CXXReadData(uint32_t addr, int len, uint8_t *d);
+
+int ee24CXXWriteData(uint32_t addr, int len, uint8_t *d);
+
+/*	Sequential read: open at an address, then read record after record without
+ *	closing the I2C transaction in between, see i2cReadOpen().
+ *
+ */
+int ee24CXXReadOpen(uint32_t addr);
+
+int ee24CXXReadNext(int len, uint8_t *d);
+
+void ee24CXXReadClose(void);
+
+#endif /* _24CXX_ */
@@ -0,0 +1,124 @@
+/*	cache.c
+ *
+ *	Small write-through block cache in RAM in front of the I2C EEPROM.
+ *
+ *	The scheduler reads the record of the next action every minute, and
+ *	usually finds it is not yet due. With the cache these repeated reads
+ *	are served from RAM instead of from the I2C bus.
+ *
+ *	Data is read from the EEPROM in lines of CACHELINESIZE bytes. When all
+ *	lines are in use the least recently used line is replaced. Writes always
+ *	go to the EEPROM, and update the data of a cached line (if any).
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include "define.h"
+#include "24cXX.h"
+#include "cache.h"
+#include "statistics.h"
+
+#define NOLINE	0xFFFFFFFF				// tag of an empty line
+
+typedef struct
+{
+	uint32_t tag;						// EEPROM address of the first byte in the line
+	uint8_t	data[CACHELINESIZE];
+} CACHELINE;
+
+static CACHELINE line[CACHELINES];
+static uint8_t lru;						// index of the least recently used line
+
+
+/*	Mark all cache lines as empty.
+ *
+ */
+void cacheInvalidate(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < CACHELINES; i++)
+		line[i].tag = NOLINE;
+}
+
+
+/*	Return the cache line holding address addr, and load it from EEPROM if needed.
+ *
+ *	Return: pointer to the line, or 0 in case of EEPROM read-error
+ *
+ */
+static CACHELINE *cacheLoad(uint32_t addr)
+{
+	uint32_t tag = addr & ~(CACHELINESIZE - 1);
+	uint8_t i;
+
+	for (i = 0; i < CACHELINES; i++)
+		if (line[i].tag == tag) {
+			statistics.cacheHits++;
+			break;
+		}
+
+	if (i == CACHELINES) {
+		statistics.cacheMisses++;
+		i = lru;
+		if (ee24CXXReadData(tag, CACHELINESIZE, line[i].data) != CACHELINESIZE) {
+			line[i].tag = NOLINE;
+			return 0;
+		}
+		line[i].tag = tag;
+	}
+
+	if (lru == i)
+		lru = (i + 1) % CACHELINES;		// exact LRU for 2 lines, round robin for more
+
+	return &line[i];
+}
+
+
+/*	Read "len" bytes starting at EEPROM address "addr" into "d" via the cache.
+ *
+ *	Return: number of bytes read, which will equal "len", or -1 in case of error
+ *
+ */
+int cacheReadData(uint32_t addr, int len, uint8_t *d)
+{
+	CACHELINE *l;
+	uint8_t offset;
+	int r = 0;
+
+	while (r < len) {
+		if ((l = cacheLoad(addr)) == 0)
+			return -1;
+		for (offset = addr & (CACHELINESIZE - 1); offset < CACHELINESIZE && r < len; offset++, addr++)
+			d[r++] = l->data[offset];
+	}
+
+	return r;
+}
+
+
+/*	Write "len" bytes from "d" to EEPROM address "addr", and update the cached copy.
+ *
+ *	Return: number of bytes written, or -1 in case of error
+ *
+ */
+int cacheWriteData(uint32_t addr, int len, uint8_t *d)
+{
+	uint32_t a;
+	uint8_t i;
+	int n, r;
+
+	r = ee24CXXWriteData(addr, len, d);
+
+	if (r != len) {
+		cacheInvalidate();				// the EEPROM content is unknown after a failed write
+		return r;
+	}
+
+	for (i = 0; i < CACHELINES; i++)
+		if (line[i].tag != NOLINE)
+			for (a = addr, n = 0; n < len; a++, n++)
+				if ((a & ~(CACHELINESIZE - 1)) == line[i].tag)
+					line[i].data[a & (CACHELINESIZE - 1)] = d[n];
+
+	return r;
+}
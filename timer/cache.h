@@ -0,0 +1,26 @@
+/*	cache.h
+ *
+ *	Defines for the RAM block cache in front of the I2C EEPROM
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _CACHE_
+#define _CACHE_
+
+#include <stdint.h>
+
+#ifndef CACHELINES
+#define CACHELINES		2				// number of cache lines
+#endif
+
+#ifndef CACHELINESIZE
+#define CACHELINESIZE	32				// bytes per cache line, must be a power of 2
+#endif
+
+void cacheInvalidate(void);
+
+int cacheReadData(uint32_t addr, int len, uint8_t *d);
+
+int cacheWriteData(uint32_t addr, int len, uint8_t *d);
+
+#endif /* _CACHE_ */
@@ -1,20 +1,21 @@
-/*	define.h
- *
- *	Generic project defines
- *
- *	2008	K.W.E. de Lange
- */
-#ifndef _DEFINE_
-#define	_DEFINE_
-
-#define SOFTWAREVERSION	2	// 1: action record contains pointer, 2: action record contains 'valid' flag
-
-#define reqOK			'1'
-#define reqERROR		'0'
-
-#define BAUD	9600		// Serial baud rate
-
-#define	OK		0			// Function return value
-#define	ERROR	-1			// Function return value
-
-#endif /* _DEFINE_ */
+/*	define.h
+ *
+ *	Generic project defines
+ *
+ *	2008	K.W.E. de Lange
+ */
+#ifndef _DEFINE_
+#define	_DEFINE_
+
+#define SOFTWAREVERSION	8	// 1: action record contains pointer, 2: action record contains 'valid' flag, 3: two schedule banks, 4: schedule header with count and CRC, 5: schedule header in AVR EEPROM, 6: date range actions, 7: sun relative actions, 8: CRC per action
+
+#define reqOK			'1'
+#define reqERROR		'0'
+
+#define BAUD	9600		// Serial baud rate
+
+#define	OK		0			// Function return value
+#define	ERROR	-1			// Function return value
+#define	BUSY	-2			// Request handler return value: the request can not be handled yet, call again later
+
+#endif /* _DEFINE_ */
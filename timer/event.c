@@ -0,0 +1,81 @@
+/*	event.c
+ *
+ *	Events which drive the main loop.
+ *
+ *	Instead of polling the serial port and the timer flag at full speed the
+ *	main loop waits for an event, and sleeps while none is pending. As every
+ *	interrupt wakes the CPU from idle sleep, an interrupt routine only has to
+ *	post an event to get its work done by the main loop.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "event.h"
+
+volatile uint8_t events;				// pending events, one bit per event
+
+
+void eventInit(void)
+{
+	events = 0;
+	set_sleep_mode(SLEEP_MODE_IDLE);	// timers and the usart keep running
+}
+
+
+/*	Post an event from the main program.
+ *
+ */
+void eventPost(uint8_t e)
+{
+	uint8_t sreg;
+
+	sreg = SREG;
+	cli();
+	events |= e;
+	SREG = sreg;
+}
+
+
+/*	Clear events before the task handling them is run, so an event which is
+ *	posted while the task runs is not lost.
+ *
+ */
+void eventClear(uint8_t e)
+{
+	uint8_t sreg;
+
+	sreg = SREG;
+	cli();
+	events &= ~e;
+	SREG = sreg;
+}
+
+
+/*	Wait until at least one event is pending and return all pending events.
+ *
+ *	The CPU sleeps until the next interrupt. Interrupts are enabled by the
+ *	instruction just before sleep_cpu(), and the AVR always executes the
+ *	instruction after sei before handling an interrupt, so an event which is
+ *	posted after the check can not be missed.
+ *
+ */
+uint8_t eventWait(void)
+{
+	uint8_t e;
+
+	for (;;) {
+		cli();
+		e = events;
+		if (e != 0)
+			break;
+		sleep_enable();
+		sei();
+		sleep_cpu();
+		sleep_disable();
+	}
+	sei();
+
+	return e;
+}
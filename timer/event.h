@@ -0,0 +1,34 @@
+/*	event.h
+ *
+ *	Defines for the events which drive the main loop
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _EVENT_
+#define _EVENT_
+
+#include <stdint.h>
+
+/*	Every event is a bit in a single byte. Events are posted by the interrupt
+ *	routines (and by tasks), and cleared by the main loop just before the task
+ *	handling it is run. Posting an event which is already pending has no effect.
+ *
+ */
+#define EVENT_MINUTE	(1<<0)			// a minute has passed, check the schedule (timer1)
+#define EVENT_RX		(1<<1)			// a byte has been received (usart0)
+#define EVENT_RF		(1<<2)			// signals are waiting in the transmit queue (remote.c)
+#define EVENT_TICK		(1<<3)			// two seconds have passed, used for timeouts (timer1)
+#define EVENT_TX		(1<<4)			// the transmit buffer has run empty (usart0)
+#define EVENT_TRACE		(1<<5)			// trace events are waiting to be sent (trace.c)
+#define EVENT_SCRUB		(1<<6)			// two seconds have passed, check some action records (timer1)
+
+extern volatile uint8_t events;
+
+#define eventPostISR(e)	(events |= (e))	// only use in an interrupt routine
+
+void eventInit(void);
+void eventPost(uint8_t e);
+void eventClear(uint8_t e);
+uint8_t eventWait(void);
+
+#endif /* _EVENT_ */
@@ -0,0 +1,161 @@
+/*	log.c
+ *
+ *	Execution log: every action queued for transmission is recorded in a
+ *	ring buffer in the I2C EEPROM, so it can be checked afterwards which
+ *	actions were executed and when.
+ *
+ *	To avoid an EEPROM write cycle per action, entries are first collected
+ *	in RAM. They are written to EEPROM when the RAM buffer is full, at the
+ *	end of every minute check and before the log is read. The number of
+ *	entries ever written is kept in AVR EEPROM; the position of the oldest
+ *	and newest entry in the ring follows from it.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include <avr/eeprom.h>
+#include "define.h"
+#include "24cXX.h"
+#include "log.h"
+
+
+static uint32_t logBase;				// EEPROM address of the ring buffer, 0 = no log
+static uint16_t logNext;				// number of entries written since the log was erased
+static uint16_t logNextEeprom EEMEM;
+
+static LOGENTRY buffer[LOGBUFFERSIZE];	// entries not yet written to EEPROM
+static uint8_t buffered;
+
+
+/*	Enable the log, using the ring buffer at EEPROM address base.
+ *
+ */
+void logInit(uint32_t base)
+{
+	logBase = base;
+	logNext = eeprom_read_word(&logNextEeprom);
+
+	if (logNext == 0xFFFF)				// erased EEPROM
+		logNext = 0;
+}
+
+
+/*	Record an action which has been queued for transmission.
+ *
+ *	dt			current date and time
+ *	lateness	seconds between the time the action was due and dt, RFNOTDUE if too
+ *				late to report; values above LOGLATENESSMAX are stored as LOGLATENESSMAX
+ *
+ *	No EEPROM write is done here, so this can be called while a sequential
+ *	read is open on the I2C bus.
+ *
+ *	If the RAM buffer is still full because logFlush() failed, the entry is lost.
+ *
+ *	Return: TRUE if the RAM buffer is full and must be written with logFlush(),
+ *			else FALSE
+ *
+ */
+boolean logAction(datetime *dt, uint8_t major, uint8_t minor, uint8_t cmd, uint8_t lateness)
+{
+	LOGENTRY *e;
+
+	if (logBase == 0)
+		return FALSE;
+
+	if (buffered == LOGBUFFERSIZE)		// the last flush failed, do not write here as a read may be open
+		return TRUE;
+
+	e = &buffer[buffered];
+
+	e->dd  = dt->dd;
+	e->mm  = dt->mm;
+	e->yy  = dt->yy;
+	e->hrs = dt->hrs;
+	e->min = dt->min;
+	e->sec = dt->sec;
+	e->unit = ((major - 'A') << 4) | ((minor - 1) & 0x0F);
+	e->cmd = (cmd ? 0x80 : 0) | (lateness > LOGLATENESSMAX ? LOGLATENESSMAX : lateness);
+
+	return (++buffered == LOGBUFFERSIZE) ? TRUE : FALSE;
+}
+
+
+/*	Write the entries collected in RAM to EEPROM.
+ *
+ *	On a write error only the entries before the failed write count as written.
+ *	The others stay in RAM, so the next call tries to write them again.
+ *
+ *	Return: OK, or ERROR in case of EEPROM write-error
+ *
+ */
+int logFlush(void)
+{
+	uint16_t index;
+	uint8_t i, n, done = 0;
+	int	result = OK;
+
+	if (buffered == 0)
+		return OK;
+
+	while (done < buffered) {
+		index = (logNext + done) % LOGENTRIES;
+		n = buffered - done;
+		if (LOGENTRIES - index < n)		// wrap around at the end of the ring
+			n = LOGENTRIES - index;
+		if (ee24CXXWriteData(logBase + index * sizeof(LOGENTRY), n * sizeof(LOGENTRY), (uint8_t *)&buffer[done]) != n * sizeof(LOGENTRY)) {
+			result = ERROR;
+			break;
+		}
+		done += n;
+	}
+
+	if (done == 0)
+		return result;
+
+	for (i = done; i < buffered; i++)	// keep the entries which were not written
+		buffer[i - done] = buffer[i];
+
+	logNext += done;
+	buffered -= done;
+
+	eeprom_update_word(&logNextEeprom, logNext);
+
+	return result;
+}
+
+
+/*	Return the number of entries in the log which have been written to EEPROM.
+ *
+ */
+uint16_t logCount(void)
+{
+	return (logBase == 0) ? 0 : (logNext < LOGENTRIES ? logNext : LOGENTRIES);
+}
+
+
+/*	Read count entries from the log, starting at entry index (0 = oldest).
+ *
+ *	Call logFlush() first to include the entries which are still in RAM.
+ *
+ *	Return: OK or ERROR (in case of EEPROM read-error)
+ *
+ */
+int logRead(uint16_t index, uint8_t count, LOGENTRY *entry)
+{
+	uint8_t n;
+
+	if (logNext >= LOGENTRIES)			// the ring is full, the oldest entry is the next to be overwritten
+		index += logNext;
+	index %= LOGENTRIES;
+
+	while (count > 0) {
+		n = count;
+		if (LOGENTRIES - index < n)
+			n = LOGENTRIES - index;
+		if (ee24CXXReadData(logBase + index * sizeof(LOGENTRY), n * sizeof(LOGENTRY), (uint8_t *)entry) != n * sizeof(LOGENTRY))
+			return ERROR;
+		entry += n;
+		count -= n;
+		index = 0;
+	}
+	return OK;
+}
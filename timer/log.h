@@ -0,0 +1,42 @@
+/*	log.h
+ *
+ *	Defines for the execution log
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _LOG_
+#define _LOG_
+
+#include <stdint.h>
+#include "ds1307.h"
+#include "utility.h"
+
+#ifndef LOGENTRIES
+#define LOGENTRIES		128				// number of entries in the log, must be a power of 2
+#endif
+
+#define LOGBUFFERSIZE	4				// entries collected in RAM before they are written to EEPROM
+
+typedef struct							// log entry layout
+{
+	uint8_t	dd;							// date and time at which the action was queued for transmission
+	uint8_t	mm;
+	uint8_t	yy;
+	uint8_t	hrs;
+	uint8_t	min;
+	uint8_t	sec;
+	uint8_t	unit;						// (major - 'A') << 4 | (minor - 1)
+	uint8_t	cmd;						// bit 7 = command (on/off), bits 0-6 = lateness in seconds (max LOGLATENESSMAX)
+} LOGENTRY;
+
+#define LOGLATENESSMAX	127				// largest lateness which fits in a log entry, also used for actions too late to report
+
+#define LOGSIZE			((uint32_t)LOGENTRIES * sizeof(LOGENTRY))
+
+void logInit(uint32_t base);
+boolean logAction(datetime *dt, uint8_t major, uint8_t minor, uint8_t cmd, uint8_t lateness);
+int logFlush(void);
+uint16_t logCount(void);
+int logRead(uint16_t index, uint8_t count, LOGENTRY *entry);
+
+#endif /* _LOG_ */
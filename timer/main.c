@@ -1,622 +1,1979 @@
-/*	main.c
- *
- *	Stand-alone timer for KlikAanKlikUit remote controlled plug-in sockets
- *
- *	2009	K.W.E. de Lange
- */
-#include <stdio.h>
-#include <stdint.h>
-#include <avr/wdt.h>
-#include <avr/eeprom.h>
-#include "define.h"
-#include "usart0.h"
-#include "ds1307.h"
-#include "24cXX.h"
-#include "remote.h"
-#include "utility.h"
-
-
-/*	Definitions and functions to enable printf output to the serial port.
- *
- */
-static int uart_putchar(char c, FILE *stream);
-
-static FILE mystdout = FDEV_SETUP_STREAM(uart_putchar, NULL,_FDEV_SETUP_WRITE);
-
-static int uart_putchar(char c, FILE *stream)
-{
-	putch(c);
-
-	return c;
-}
-
-
-/*	Automatically disable the watchdog after system reset.
- *
- *	After a system reset the watchdog timer is set by default to 15 mS. Beware that it is not disabled automatically.
- *	Only after a power-on the timer is stopped.
- *
- */
-uint8_t mcusr_mirror __attribute__ ((section (".noinit")));
-
-void wdt_init(void) __attribute__((naked)) __attribute__((section(".init3")));	// .init3 is run after stack initialization
-
-void wdt_init(void)
-{
-	mcusr_mirror = MCUSR;				// save source of reset + clear the watchdog reset flag
-	MCUSR = 0;							// disable the watchdog timer
-	wdt_disable();
-}
-
-
-typedef struct							// timer action record layout
-{
-	uint8_t valid;						// <> 0 if entry is valid, else 0
-	uint8_t	major;						// major unit id, characters 'A' to 'P'
-	uint8_t	minor;						// minor unit id, integers 1 to 16
-	uint8_t	dd;							// day fraction of date, or 0 in case of no date
-	uint8_t	mm;							// month fraction of date, or 0 in case of no date
-	uint8_t yy;							// year fraction of date, or 0 in case of no date
-	uint8_t day;						// weekday number (ISO numbering, Monday = 1), or 0 in case of no weekday
-	uint8_t	hrs;						// hour fraction of time when to execute
-	uint8_t	min;						// minute fraction of time when to execute
-	uint8_t	cmd;						// switch off if cmd == 0 else switch on
-} ACTION;
-
-typedef struct							// hardware info record layout
-{
-	uint8_t	version;					// hardware version
-	uint8_t	memoryType;					// type of EEPROM: 0 = AVR EEPROM, 1 = I2C EEPROM
-	uint32_t memorySize;				// memory size in bytes
-} HARDWARE;
-
-
-HARDWARE hardware;						// hardware information
-
-int maxActionIndex;						// the maximum number of actions which can be stored in EEPROM
-volatile boolean timerWakeup;			// flag indicating whether the timer must wake up
-volatile boolean timerEnable;			// flag to enable or disable the timer, regardless of wakeup
-volatile long disableTimeOut;			// counter to arrange automatic reset of timerEnable to TRUE
-boolean verbose = FALSE;				// flag indicating whether debugging output must be sent to the client terminal
-
-
-typedef enum
-{
-	INIT,
-	NORMAL
-} run_t;								// ..
-
-
-void timer1Init(void);
-void parse(void);
-int getTime(void);
-int setTime(void);
-int setAction(void);
-int getAction(void);
-int switchUnit(void);
-int getInfo(void);
-int	setInfo(void);
-int	countActions();
-void initActions(void);
-void checkActions(run_t type);
-void executeActions(int from, int to, int dd, int mm, int yy, int day, run_t type);
-int	readAction(int index, ACTION *action);
-int	writeAction(int index, ACTION *action);
-
-
-int main(void)
-{
-	stdout = &mystdout;										// for use of printf
-
-	/*	Hardware initialization
-	 *
-	 */
-	MCUSR = 0;
-	wdt_disable();
-
-	usart0Init();
-	timer1Init();
-	i2cInit();
-
-	/*	Load and process timer device information
-	 *
-	 */
-	DS1307ReadData(0x08, sizeof(HARDWARE), (uint8_t *)&hardware);
-	maxActionIndex = (hardware.memorySize / sizeof(ACTION));
-
-	sei();
-
-	/*	Start executing actions
-	 *
-	 */
-	initActions();											// initialize various pointers
-
-	timerEnable = TRUE;
-
-	for (;;) {
-		while (usart0inBufferCount() > 0)					// continuously check for a command from the client ..
-			parse();										// .. and parse the input if any was received
-		if (timerWakeup == TRUE && timerEnable == TRUE) {	// wakeup is set to TRUE every minute via timer1 interrupt routine
-			checkActions(NORMAL);							// execute any actions
-			timerWakeup = FALSE;							// wait for timer1 interrupt routine to clear wakeup again in a minute
-		}
-	}
-	return 0;
-}
-
-
-/*	Client request parser
- *
- */
-void parse(void)
-{
-	while (usart0inBufferCount() > 0) {
-		switch (getch()) {
-			case 'A':	timerEnable = TRUE;			// start executing timer actions every minute
-						putch(reqOK);
-						break;
-			case 'B': 	timerEnable = FALSE;		// stop the timer from executing actions
-						disableTimeOut = 10;		// the timer will automatically be re-enabled after 10 minutes
-						verbose = FALSE;			// no more need for verbose once the timer has stopped
-						putch(reqOK);
-						break;
-			case 'C': 	getTime();					// send the DS1307 date and time to the client
-						break;
-			case 'D':	if (setTime() == ERROR)		// receive date and time from the client and set the DS1307
-							putch(reqERROR);
-						else
-							putch(reqOK);
-						break;
-			case 'E':	getAction();				// send a specific action to the client
-						break;
-			case 'F':	if (setAction() == ERROR)	// receive a specific action from the client and write to memory
-							putch(reqERROR);
-						else
-							putch(reqOK);
-						break;
-			case 'G': 	if (switchUnit() == ERROR)	// receive and action from the client which must be executed immediately
-							putch(reqERROR);
-						else
-							putch(reqOK);
-						break;
-			case 'H':	getInfo();					// send device info to the client
-						break;
-			case 'I':	setInfo();					// receive device info from the client
-						break;
-			case 'J':	verbose = TRUE;				// enable debugging output (how? connect via terminal, send 'A' and then 'I')
-						putch(reqOK);
-						printf("\r\nVerbose On\r\n");
-						break;
-			case 'K':	// do not use watchdog reset on a mySmartControl; if you do the device will not exit from the bootloader
-						//wdt_enable(WDTO_15MS);	// set watchdog timer to 15mS
-						//WDTCSR = 0x08;
-						for (;;) { }				// wait for user to press reset
-						break;
-			default:	putch(reqERROR); 			// unknown request, ignore
-						break;
-		} // switch
-	} // while
-}
-
-
-/*	Send current DS1307 date and time to the client.
- *
- *	Message sent (7 bytes):
- *
- *	0	day of date (as integer)
- *	1	month of date (as integer)
- *	2	year of date (as integer)
- *	3	weekday of date (as integer)
- *	4	hours of time (as integer)
- *	5	minutes of time (as integer)
- *	6	seconds of time (as integer)
-
- *	Return: OK when successful, ERROR if date and time could not be retrieved
- *
- */
-int getTime()
-{
-	datetime dt;
-
-	if (DS1307GetTime(&dt) == ERROR)
-		return ERROR;
-
-	putch(dt.dd);
-	putch(dt.mm);
-	putch(dt.yy);
-	putch(dt.day);
-	putch(dt.hrs);
-	putch(dt.min);
-	putch(dt.sec);
-
-	return OK;
-}
-
-
-/*	Receive new date and time from client and set the DS1307 internal clock.
- *	Checks for validity of date and time
- *
- *	Message received (7 bytes):
- *
- *	0	day of date (as integer)
- *	1	month of date (as integer)
- *	2	year of date (as integer)
- *	3	weekday of date (as integer)
- *	4	hours of time (as integer)
- *	5	minutes of time (as integer)
- *	6	seconds of time (as integer)
- *
- *	Return: OK when successful, ERROR if invalid date or time or when DS1307 could not be written
- *
- */
-int setTime()
-{
-	datetime dt;
-
-	dt.dd  = getch();
-	dt.mm  = getch();
-	dt.yy  = getch();
-	dt.day = getch();
-	dt.hrs = getch();
-	dt.min = getch();
-	dt.sec = getch();
-
-	if (dt.dd < 1 || dt.dd > 31)
-		return ERROR;
-	if (dt.mm < 1 || dt.mm > 12)
-		return ERROR;
-	if (dt.yy > 99)
-		return ERROR;
-	if (dt.day < 1 || dt.day > 7)
-		return ERROR;
-	if (dt.hrs > 23)
-		return ERROR;
-	if (dt.min > 59)
-		return ERROR;
-	if (dt.sec > 59)
-		return ERROR;
-
-	return DS1307SetTime(&dt);
-}
-
-
-/*	Retrieve an action from memory and send it to client.
- *
- *	Client first sends a 16-bit unsigned integer containing the index of the action to retrieve.
- *	Server then sends the action content to the client.
- *
- *	Message received (2 bytes):
- *
- *	0		low byte of index (as integer)
- *	1		high byte of index (as integer)
- *
- *	Message sent (SIZEOF(ACTION) bytes):
- *
- *	0-9		content of action
- *
- *	Return: OK when successful, ERROR in case of error reading the action from memory.
- *
- */
-int getAction()
-{
-	uint16_t index;
-	uint8_t i, lo, hi, data[sizeof(ACTION)];
-
-	lo = getch();
-	hi = getch();
-
-	index = (hi * 0xFF) + lo;
-
-	if (readAction(index, (ACTION *)&data) == ERROR)
-		return ERROR;
-
-	for (i = 0; i < sizeof(ACTION); i++)
-		putch(data[i]);
-
-	return OK;
-}
-
-
-/*	Receive an action from the client and store it in memory.
- *
- *	Client first sends a 16-but unsigned integer containing the index of the action,
-  * followed by the content of the action.
- *
- *	Message received (2 + SIZEOF(ACTION) bytes):
- *
- *	0		low byte of index (as integer)
- *	1		high byte of index (as integer)
- *	2-12	content of action
- *
- */
-int setAction()
-{
-	uint16_t index;
-	uint8_t i, lo, hi, data[sizeof(ACTION)];
-
-	lo = getch();
-	hi = getch();
-
-	for (i = 0; i < sizeof(ACTION); i++)
-		data[i] = getch();
-
-	index = (hi * 0xFF) + lo;
-	
-	if (writeAction(index, (ACTION *)&data) == ERROR)
-			return ERROR;
-
-	return OK;
-}
-
-
-/*	Receive a command from the client to immediately send to a switch.
- *
- *	Message received (3 bytes):
- *
- *	0		major device id (as character, values: 'A' to 'P')
- * 	1		minor device id (as integer, values: 1 to 16)
- * 	2		command (as integer, values: 0 or 1 (off / on))
- *
- *	Return: OK if parameter values were valid, else ERROR
- *
- */
-int switchUnit()
-{
-	uint8_t major, minor, command;
-
-	major   = getch();
-	minor   = getch();
-	command = getch();
-
-	if ((char)major >= 'A' && (char)major <= 'P')
-		if (minor >= 1 && minor <= 16)
-			if (command >= 0 && command <= 1) {
-				sendSignal(major, minor, command);
-				return OK;
-			}
-	return ERROR;
-}
-
-
-/*	Transmit a string with 24 bytes of device info to the client.
- *
- *	Message sent (24 bytes):
- *
- *	0-2		hardware version (as string)
- *	3-5		software version (as string)
- *	6-10	data-memory size (as string)
- *	11-15	number of valid actions in memory (as string)
- *	16-23	reserved for future use
- *
- */
-int getInfo()
-{
-	int	i;
-	char buffer[8];
-
-	sprintf(&buffer[0], "%3d", hardware.version);		// hardware version as string[3]
-
-	for (i = 0; i < 3; i++)
-		putch(buffer[i]);
-
-	sprintf(&buffer[0], "%3d", SOFTWAREVERSION);		// software version as string[3]
-
-	for (i = 0; i < 3; i++)
-		putch(buffer[i]);
-
-	sprintf(&buffer[0], "%05lu", hardware.memorySize);	// data-memory size as string[5]
-
-	for (i = 0; i < 5; i++)
-		putch(buffer[i]);
-
-	sprintf(&buffer[0], "%05d", countActions());		// number of valid actions in memory as string[5]
-
-	for (i = 0; i < 5; i++)
-		putch(buffer[i]);
-
-	for (i = 0; i < 8; i++)								// 8 bytes reserved for future use as string[8]
-		putch('0');
-
-	return OK;
-}
-
-
-/*	Write system information to the DS1307 memory.
- *
- *	Used only by manufacturer to initialize the device.
- *
- *	Message received (8 bytes):
- *
- *	0		hardware version (as integer, values: 0 to 255)
- *	1		memory type (as integer, values: 0 for internal EEPROM, 1 for I2C EEPROM)
- *	2-5		memory size in bytes (as integer, little-endian (low byte first then high byte, is the AVR GCC standard))
- *	6		magic number = 0xFE
- *	7		magic number = 0xAB
- *
- */
-int	setInfo(void)
-{
-	uint8_t	i, data[8];
-
-	for (i = 0; i < 8; i++)
-		data[i] = getch();
-
-	if (data[6] == 0xFE && data[7] == 0xAB) {				// check magic number as security measure to avoid unintended writes
-		DS1307WriteData(0x08, 6, (uint8_t *)&data[0]);
-
-		cli();
-		// wdt_enable(WDTO_15MS); 							// set watchdog timer to 15mS -> do not use on a mySmartControl
-		for (;;) {}											// basic information has changed, wait for user to press reset
-	}
-	return ERROR;
-}
-
-
-/*	Initialize action counter to position based on the current time.
- *
- */
-void initActions(void)
-{
-	checkActions(INIT);
-}
-
-
-/*	Check if time has passed between the previous and the current call of this function,
- *	and if so then execute any action in between.
- *
- *	type = INIT to increase the counter to the current time without executing actions
- *
- */
-void checkActions(run_t type)
-{
-	static int prev;
-	int	curr;
-	datetime dt;
-
-	DS1307GetTime(&dt);
-
-	if (verbose == TRUE) {
-		if (type == INIT)
-			printf("start initializing actions: checkActions\r");
-		printf("start checking actions on %02d-%02d-%02d (%d) %02d:%02d:%02d\r\n", dt.dd, dt.mm, dt.yy, dt.day, dt.hrs, dt.min, dt.sec);
-	}
-
-	curr = dt.hrs * 60 + dt.min;
-
-	if (verbose == TRUE)
-		printf("current minute=%d\r\n", curr);
-
-	if (curr == prev) 										// no time passed between now and previous call
-		return;
-
-	if (curr > prev)										// new call done later then previous call
-		executeActions(prev, curr, dt.dd, dt.mm, dt.yy, dt.day, type);
-	else {													// new call earlier then previous call, moved past midnight
-		executeActions(prev, 24*60, dt.dd, dt.mm, dt.yy, dt.day, type);
-		executeActions(0, curr, dt.dd, dt.mm, dt.yy, dt.day, type);
-	}
-	prev = curr;
-
-	if (verbose == TRUE) {
-		if (type == INIT)
-			printf("end initializing actions\r");
-		printf("end checking actions\r\n");
-	}
-}
-
-
-/*	Execute actions inside time interval
- *
- *	Time interval (from, to) expressed as minutes since 00:00
- *
- *	from = inclusive
- *	to 	 = exclusive
- *
- *	dd-mm-yy = date
- *	weekday  = weekday
- *	type	 = INIT to increase counter without executing actions
- *
- */
-void executeActions(int from, int to, int dd, int mm, int yy, int weekday, run_t type)
-{
-	ACTION a;
-	int	time;
-	int	first;
-	static int next;
-
-	if (verbose == TRUE)
-		printf("execute actions between %d (incl) and %d (excl) on date %d-%d-%d, day %d\r\n", from, to, dd, mm, yy, weekday);
-
-	first = next;
-
-	do {
-		if (readAction(next, &a) == ERROR)					// Load the next action from EEPROM.
-			break;
-
-		if (a.valid == 0) {									// An invalid entry means we are at the end of the list.
-			if (next == 0)									// If action[0] is invalid ...
-				break;										// ... then the list is empty: stop
-			next = 0;										// else we need to go back to the top ...
-			continue;										// ... so wrap around and continue.
-		}
-
-		time = a.hrs * 60 + a.min;							// Minute at which action should run
-
-		if (verbose == TRUE)
-			printf("next action due at %d\r\n", time);
-
-		if (time >= from && time < to) {					// Is the time the action should run inside the interval?
-			if (a.day == 0 || a.day == weekday) {			// Are we on the right weekday (if weekday is relevant)?
-				if (a.dd == 0 || a.mm == 0 || (a.dd == dd && a.mm == mm && a.yy == yy)) {	// Are we on the right date (if date is relevant)?
-					if (verbose == TRUE)
-						printf("action: %02d-%02d-%02d (%d) %02d:%02d %c-%02d=%d\r\n",
-								a.dd, a.mm, a.yy, a.day, a.hrs, a.min, a.major, a.minor, a.cmd);
-					if (type != INIT)						// INIT just advances counters and does not execute
-						sendSignal(a.major, a.minor, a.cmd);// Execute the action
-				}
-			}
-			next += 1;										// Goto the next action to execute.
-			if (next == maxActionIndex)						// If we are at the end of the list ...
-				next = 0;									// ... then wrap around to the top.
-		} else
-			break;
-	} while (next != first); 								// Avoid looping (in case of list with single entry)
-}
-
-
-/*	Count the number of valid actions in the EEPROM.
- *
- *	Return: count, or 0 in case of EEPROM read-error
- *
- */
-int countActions()
-{
-	ACTION action;
-	int	count = 0;
-
-	for (count = 0; count < maxActionIndex; count++) {
-		if (readAction(count, &action) == ERROR) {
-			count = 0;
-			break;
-		}
-		if (action.valid == 0)
-			break;
-	}
-	return count;
-}
-
-
-/*	Read the action at position index from the EEPROM.
- *
- *	Return: OK or ERROR (in case if invalid index or EEPROM read-error)
- *
- */
-int	readAction(int index, ACTION *action)
-{
-	if (index < maxActionIndex)
-		if (ee24C65ReadData(index * sizeof(ACTION), sizeof(ACTION), (uint8_t *)action) == sizeof(ACTION))
-			return OK;
-
-	return ERROR;
-}
-
-
-/*	Write action to the EEPROM at position index.
- *
- *	Return: OK or ERROR (in case of invalid index or EEPROM write-error)
- *
- */
-int	writeAction(int index, ACTION *action)
-{
-	if (index < maxActionIndex) {
-		if (action->valid == 1) {
-			if (ee24C65WriteData(index * sizeof(ACTION), sizeof(ACTION), (uint8_t *)action) == sizeof(ACTION))
-				return OK;
-		} else {
-			/* for an invalid action record only write field action->valid to the EEPROM */
-			if (ee24C65WriteData(index * sizeof(ACTION), sizeof(uint8_t), (uint8_t *)action) == sizeof(uint8_t))
-				return OK;
-		}
-	}
-	return ERROR;
-}
+/*	main.c
+ *
+ *	Stand-alone timer for KlikAanKlikUit remote controlled plug-in sockets
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include <stdint.h>
+#include <avr/wdt.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <util/crc16.h>
+#include "define.h"
+#include "usart0.h"
+#include "ds1307.h"
+#include "24cXX.h"
+#include "cache.h"
+#include "storage.h"
+#include "log.h"
+#include "remote.h"
+#include "statistics.h"
+#include "trace.h"
+#include "event.h"
+#include "profile.h"
+#include "sram.h"
+#include "sun.h"
+#include "utility.h"
+
+
+/*	Automatically disable the watchdog after system reset.
+ *
+ *	After a system reset the watchdog timer is set by default to 15 mS. Beware that it is not disabled automatically.
+ *	Only after a power-on the timer is stopped.
+ *
+ */
+uint8_t mcusr_mirror __attribute__ ((section (".noinit")));
+
+void wdt_init(void) __attribute__((naked)) __attribute__((section(".init3")));	// .init3 is run after stack initialization
+
+void wdt_init(void)
+{
+	mcusr_mirror = MCUSR;				// save source of reset + clear the watchdog reset flag
+	MCUSR = 0;							// disable the watchdog timer
+	wdt_disable();
+}
+
+
+#define ACTIONDATE		1				// action on a specific date, or on any date
+#define ACTIONRANGE		2				// action on a range of dates
+#define ACTIONSUNRISE	3				// action relative to sunrise
+#define ACTIONSUNSET	4				// action relative to sunset
+
+#define ACTIONCRC		0xFF			// start value of the CRC-8 of an action record, so an all zero record is not valid
+
+typedef struct							// timer action record layout
+{
+	uint8_t valid;						// ACTIONDATE, ACTIONRANGE, ACTIONSUNRISE or ACTIONSUNSET if entry is valid, else 0
+	uint8_t	major;						// major unit id, characters 'A' to 'P'
+	uint8_t	minor;						// minor unit id, integers 1 to 16
+	uint8_t	dd;							// day fraction of date, or 0 in case of no date
+	uint8_t	mm;							// month fraction of date, or 0 in case of no date
+	uint8_t yy;							// year fraction of date, or 0 in case of no date
+	uint8_t day;						// weekday number (ISO numbering, Monday = 1), or 0 in case of no weekday
+	uint8_t	hrs;						// hour fraction of time when to execute
+	uint8_t	min;						// minute fraction of time when to execute
+	uint8_t	cmd;						// switch off if cmd == 0 else switch on
+	uint8_t	crc;						// CRC-8 over the preceding bytes, see actionCheck()
+} ACTION;
+
+typedef struct							// date range action record layout (valid == ACTIONRANGE), same size as ACTION
+{
+	uint8_t valid;						// ACTIONRANGE
+	uint8_t	major;						// major unit id, characters 'A' to 'P'
+	uint8_t	minor;						// minor unit id, integers 1 to 16
+	uint16_t first;						// first day on which to execute, as day number (see dayNumber())
+	uint8_t	days;						// number of days after the first day on which to execute as well (0 to 255)
+	uint8_t day;						// weekday number (ISO numbering, Monday = 1), or 0 in case of no weekday
+	uint8_t	hrs;						// hour fraction of time when to execute
+	uint8_t	min;						// minute fraction of time when to execute
+	uint8_t	cmd;						// switch off if cmd == 0 else switch on
+	uint8_t	crc;						// CRC-8 over the preceding bytes, see actionCheck()
+} RANGEACTION;
+
+typedef struct							// sun relative action record layout (valid == ACTIONSUNRISE or ACTIONSUNSET), same size as ACTION
+{
+	uint8_t valid;						// ACTIONSUNRISE or ACTIONSUNSET
+	uint8_t	major;						// major unit id, characters 'A' to 'P'
+	uint8_t	minor;						// minor unit id, integers 1 to 16
+	uint8_t	dd;							// day fraction of date, or 0 in case of no date
+	uint8_t	mm;							// month fraction of date, or 0 in case of no date
+	uint8_t yy;							// year fraction of date, or 0 in case of no date
+	uint8_t day;						// weekday number (ISO numbering, Monday = 1), or 0 in case of no weekday
+	int16_t	offset;						// minutes after (or if negative before) sunrise or sunset
+	uint8_t	cmd;						// switch off if cmd == 0 else switch on
+	uint8_t	crc;						// CRC-8 over the preceding bytes, see actionCheck()
+} SUNACTION;
+
+typedef struct							// schedule header layout, stored in the AVR EEPROM
+{
+	uint8_t	version;					// layout version of header and actions, equals SOFTWAREVERSION
+	uint8_t	bank;						// bank containing the active schedule (0 or 1)
+	uint16_t generation;				// incremented every time a new schedule is activated
+	uint16_t count;						// number of valid actions in the active schedule
+	uint16_t crc;						// CRC-CCITT over the valid actions in the active schedule
+	uint16_t timed;						// number of actions with a fixed time, sorted on time; the sun relative actions follow
+} SCHEDULE;
+
+typedef struct							// hardware info record layout
+{
+	uint8_t	version;					// hardware version
+	uint8_t	memoryType;					// type of EEPROM: 0 = AVR EEPROM, 1 = I2C EEPROM, high nibble = number of I2C EEPROMs - 1
+	uint32_t memorySize;				// memory size in bytes (of all I2C EEPROMs together)
+} HARDWARE;
+
+
+HARDWARE hardware;						// hardware information
+SCHEDULE schedule;						// schedule header
+STATISTICS statistics;					// performance counters
+LATENESS lateness;						// histogram of the delay between the time an action was due and its transmission
+const STORAGE *storage;					// backend holding the action table
+
+int maxActionIndex;						// the maximum number of actions which can be stored in a schedule bank
+volatile boolean timerEnable;			// flag to enable or disable the timer, regardless of wakeup
+volatile long disableTimeOut;			// counter to arrange automatic reset of timerEnable to TRUE
+boolean verbose = FALSE;				// flag indicating whether trace events must be sent to the client
+boolean scheduleIntact = TRUE;			// FALSE if the CRC over the active schedule does not match the one in its header
+
+static int prev;						// minute (since 00:00) at which the actions were last checked
+static int next;						// index of the next action to execute
+static int checkTo;						// end of the interval checkActions() could not finish, 0 = none
+static uint16_t sunNext;				// index of the next sun relative action to check in that interval
+
+static SCHEDULE scheduleEeprom[2] EEMEM;	// two copies of the schedule header, written alternately
+
+
+#define STREAMCHUNK	(TxBufLength / 2)	// number of bytes read at once from EEPROM when streaming actions
+#define STREAMMAX	32					// maximum number of records sent by getActions() or getLog(), see STREAMBLOCK in client/const.py
+
+#ifndef PARSETIMEOUT
+#define PARSETIMEOUT	1000				// milliseconds without new bytes after which an incomplete request is discarded
+#endif
+
+#define SYNCMAXWAIT		900				// milliseconds syncTime() will wait at most for the moment to set the clock
+#define TICKMAXWAIT		1100				// milliseconds getTick() will wait at most for the DS1307 seconds to change
+
+#define LATEREPORTMAX	3					// minutes after which an action is too late to report its lateness (max 3, see RFNOTDUE)
+
+#ifndef SCRUBRECORDS
+#define SCRUBRECORDS	8					// number of action records checked by every run of the scrub task
+#endif
+
+/*	Storage layout: two banks which each hold a schedule. The timer executes the actions
+ *	in the active bank, a new schedule is written to the other bank. A single write of
+ *	the schedule header (in AVR EEPROM) then makes the new schedule active.
+ *
+ *	Within a bank the actions with a fixed time come first, sorted on time. The sun
+ *	relative actions, whose time changes every day, are placed after them.
+ *
+ */
+#define bankAddress(bank)	((uint32_t)(bank) * maxActionIndex * sizeof(ACTION))
+
+
+void timer1Init(void);
+uint16_t timer1Millis(void);
+void parse(void);
+void minuteTask(void);
+void transmitTask(void);
+void scrubTask(void);
+int startTimer(void);
+int stopTimer(void);
+int setVerbose(void);
+int reset(void);
+int getTime(void);
+int setTime(void);
+int echoTime(void);
+int syncTime(void);
+int getTick(void);
+int setAction(void);
+int getAction(void);
+int getActions(void);
+int switchUnit(void);
+int switchScene(void);
+int getInfo(void);
+int	setInfo(void);
+int getStatistics(void);
+int getUnitConfig(void);
+int getLog(void);
+int getProfile(void);
+int getMemory(void);
+int getUnitStates(void);
+int getLateness(void);
+int setUnitConfig(void);
+int	countActions(uint8_t bank, uint16_t *crc, uint16_t *timed);
+void scheduleLoad(void);
+boolean scheduleVerify(void);
+int	scheduleSave(SCHEDULE *header);
+void initActions(void);
+void positionActions(int minute);
+void checkActions(void);
+int	executeActions(int from, int to, datetime *dt);
+int	executeSunActions(int from, int to, datetime *dt);
+int	readAction(uint16_t index, ACTION *action);
+int	openActions(uint8_t bank, uint16_t index);
+int	nextAction(ACTION *action);
+void closeActions(void);
+int	writeAction(uint16_t index, ACTION *action);
+boolean actionCheck(ACTION *action);
+void actionCorrupt(uint16_t index);
+int activateSchedule(void);
+
+
+/*	Main loop tasks
+ *
+ *	The main loop sleeps until an event is posted, and then runs the first task
+ *	in this table which handles a pending event. After every task the table is
+ *	searched again from the top, so the minute check never waits longer than
+ *	the duration of a single other task (see statistics.loopLatencyMax).
+ *
+ */
+typedef struct
+{
+	uint8_t	events;						// events which make the task ready to run
+	void	(*handler)(void);
+} TASK;
+
+static const TASK taskTable[] PROGMEM = {					// in order of priority
+	{ EVENT_MINUTE,				minuteTask },			// execute the actions which are due
+	{ EVENT_RX | EVENT_TICK,	parse },				// handle received requests, discard stalled ones
+	{ EVENT_RF,					transmitTask },			// transmit queued signals
+	{ EVENT_TX | EVENT_TRACE,	traceTask },			// send trace events when the serial port is idle
+	{ EVENT_SCRUB,				scrubTask }				// check a few action records for corruption
+};
+
+
+int main(void)
+{
+	TASK task;
+	uint16_t taskStart, taskTime;
+	uint8_t i, pending;
+
+	/*	Hardware initialization
+	 *
+	 */
+	MCUSR = 0;
+	wdt_disable();
+
+	eventInit();
+	usart0Init();
+	timer1Init();
+	i2cInit();
+#ifdef PROFILE
+	profileInit();
+#endif
+
+	unitConfigLoad();
+
+	/*	Load and process timer device information
+	 *
+	 */
+	DS1307ReadData(0x08, sizeof(HARDWARE), (uint8_t *)&hardware);
+
+	if ((hardware.memoryType & 0x0F) == 0) {				// no I2C EEPROM: keep the actions in AVR EEPROM
+		storage = &avrStorage;
+		maxActionIndex = AVRSTORAGESIZE / 2 / sizeof(ACTION);
+	} else {
+		storage = &i2cStorage;
+		maxActionIndex = (hardware.memorySize - LOGSIZE) / 2 / sizeof(ACTION);
+		ee24CXXInit((hardware.memoryType >> 4) + 1, hardware.memorySize);
+		cacheInvalidate();
+		logInit(hardware.memorySize - LOGSIZE);			// the execution log is kept at the end of the I2C EEPROM
+	}
+
+	scheduleLoad();
+
+	scheduleIntact = scheduleVerify();
+
+	unitStateLoad();
+
+	sei();
+
+	/*	Start executing actions
+	 *
+	 */
+	initActions();											// initialize various pointers
+
+	timerEnable = TRUE;
+
+	for (;;) {
+		pending = eventWait();								// sleep until an interrupt posts an event
+
+		for (i = 0; i < sizeof(taskTable) / sizeof(TASK); i++) {
+			memcpy_P(&task, &taskTable[i], sizeof(TASK));
+
+			if (pending & task.events) {
+				eventClear(task.events);					// events posted while the task runs are kept
+
+				taskStart = timer1Millis();
+				task.handler();
+				taskTime = timer1Millis() - taskStart;		// keep track of the worst-case duration of a task
+				if (taskTime > statistics.loopLatencyMax)
+					statistics.loopLatencyMax = taskTime;
+				break;
+			}
+		}
+	}
+	return 0;
+}
+
+
+/*	Check the schedule, called every minute.
+ *
+ */
+void minuteTask(void)
+{
+	if (timerEnable == TRUE)
+		checkActions();										// queue any actions
+
+#if UNITREFRESH
+	unitRefresh();
+#endif
+}
+
+
+/*	Transmit queued signals, but leave time to handle requests and the minute check.
+ *
+ *	If the minute check stopped because the transmit queue was full it is
+ *	continued here, now that signals have been sent.
+ *
+ */
+void transmitTask(void)
+{
+	rfTask(RFBUDGET);
+
+	if (checkTo != 0 && timerEnable == TRUE)
+		checkActions();
+
+	unitStateSave();
+}
+
+
+/*	Check the CRC of the next SCRUBRECORDS actions of the active schedule.
+ *
+ *	Runs every two seconds when no other task is waiting, so an EEPROM error is
+ *	found before the action is due. The position is kept between runs; every
+ *	complete check of the schedule is counted in statistics.scrubPasses, and at
+ *	its end the CRC over all actions is compared with the schedule header.
+ *
+ */
+void scrubTask(void)
+{
+	static uint16_t index, crc, generation;
+	ACTION a;
+	uint8_t	i, j;
+	uint16_t start, time;
+
+	if (schedule.count == 0)
+		return;
+
+	start = timer1Millis();
+
+	if (generation != schedule.generation || index >= schedule.count) {	// another schedule has been activated
+		generation = schedule.generation;
+		index = 0;
+	}
+
+	if (openActions(schedule.bank, index) == ERROR)
+		return;
+
+	for (i = 0; i < SCRUBRECORDS; i++) {
+		if (nextAction(&a) == ERROR)
+			return;											// the bus has already been released
+		if (actionCheck(&a) == FALSE)
+			actionCorrupt(index);
+		if (index == 0)
+			crc = 0xFFFF;
+		for (j = 0; j < sizeof(ACTION); j++)
+			crc = _crc_ccitt_update(crc, ((uint8_t *)&a)[j]);
+		if (++index == schedule.count) {
+			index = 0;
+			scheduleIntact = (crc == schedule.crc) ? TRUE : FALSE;
+			statistics.scrubPasses++;
+			break;
+		}
+	}
+
+	closeActions();
+
+	time = timer1Millis() - start;
+	if (time > statistics.scrubTimeMax)
+		statistics.scrubTimeMax = time;
+}
+
+
+/*	Client request parser
+ *
+ *	Every request consists of a single opcode byte followed by a payload. The
+ *	length of the payload is found in the command table. For a request with a
+ *	list of items (like 'L') the first payload byte holds the number of items.
+ *
+ *	The parser never waits for bytes to arrive. Once the opcode has been read
+ *	the payload is left in the receive buffer until it is complete, and only
+ *	then the handler is called, which can read its payload without waiting.
+ *	If no bytes arrive for PARSETIMEOUT milliseconds while a payload is
+ *	incomplete, the partial request is discarded and reqERROR is sent. The
+ *	parser runs on every received byte and on every EVENT_TICK, so a stalled
+ *	request is discarded within PARSETIMEOUT plus two seconds. A handler which
+ *	can not do its work yet (like 'L' while the transmit queue is full) returns
+ *	BUSY without reading its payload, and is called again on the next EVENT_TICK. A request which
+ *	does not fit in the receive buffer is answered with reqERROR at once, and
+ *	its payload is skipped as it arrives, until all of it has been skipped or
+ *	the line has been idle for PARSETIMEOUT milliseconds.
+ *
+ */
+typedef struct
+{
+	uint8_t	opcode;
+	uint8_t	length;						// bytes of fixed payload
+	uint8_t	itemLength;					// bytes per item, 0 = no list of items
+	uint8_t	reply;						// TRUE = the parser sends reqOK or reqERROR based on the handler's result
+	int		(*handler)(void);
+} COMMAND;
+
+static const COMMAND commandTable[] PROGMEM = {
+	{ 'A', 0,						0, TRUE,  startTimer },		// start executing timer actions every minute
+	{ 'B', 0,						0, TRUE,  stopTimer },		// stop the timer from executing actions
+	{ 'C', 0,						0, FALSE, getTime },		// send the DS1307 date and time to the client
+	{ 'D', 7,						0, TRUE,  setTime },		// receive date and time from the client and set the DS1307
+	{ 'E', 2,						0, FALSE, getAction },		// send a specific action to the client
+	{ 'F', 2 + sizeof(ACTION),		0, TRUE,  setAction },		// receive a specific action from the client and write to memory
+	{ 'G', 3,						0, TRUE,  switchUnit },		// receive and action from the client which must be executed immediately
+	{ 'H', 0,						0, FALSE, getInfo },		// send device info to the client
+	{ 'I', 8,						0, FALSE, setInfo },		// receive device info from the client
+	{ 'J', 0,						0, TRUE,  setVerbose },		// enable trace events (decode them with client/tracer.py)
+	{ 'K', 0,						0, FALSE, reset },			// wait for the user to press reset
+	{ 'L', 1,						3, TRUE,  switchScene },	// receive a list of actions from the client which must be executed immediately
+	{ 'M', 0,						0, FALSE, getStatistics },	// send performance counters to the client
+	{ 'N', 0,						0, FALSE, getUnitConfig },	// send the unit configuration table to the client
+	{ 'O', sizeof(unitConfig),		0, TRUE,  setUnitConfig },	// receive the unit configuration table from the client
+	{ 'P', 4,						0, FALSE, getActions },		// send a range of actions to the client
+	{ 'Q', 0,						0, TRUE,  activateSchedule },	// make the schedule written by 'F' the active one
+	{ 'R', 4,						0, TRUE,  getLog },			// send a range of entries of the execution log to the client
+	{ 'S', 0,						0, FALSE, getProfile },		// send the execution time per profiled function to the client
+	{ 'T', 0,						0, FALSE, getMemory },		// send the SRAM usage to the client
+	{ 'U', 0,						0, FALSE, getUnitStates },	// send the last command sent to every unit to the client
+	{ 'V', 1,						0, FALSE, echoTime },		// echo a byte with the millisecond clock, to measure the latency
+	{ 'W', 9,						0, TRUE,  syncTime },		// receive date and time from the client and set the DS1307 at a given moment
+	{ 'X', 0,						0, FALSE, getTick },		// wait for the next DS1307 second and send the date and time to the client
+	{ 'Y', 1,						0, FALSE, getLateness }		// send the lateness histogram of the executed actions to the client
+};
+
+#if (1 + SCENESIZE * 3 >= RxHighWater) || (UNITCONFIGSIZE * 4 >= RxHighWater)
+#error the payload of a request must fit in the receive buffer below RxHighWater
+#endif
+
+
+void parse(void)
+{
+	static COMMAND command;					// request being received, opcode 0 = none
+	static uint8_t received;				// payload bytes in the receive buffer at the last check
+	static uint16_t since;					// time in milliseconds at which received last changed
+	static uint16_t skip;					// payload bytes of a request too long for the receive buffer still to be discarded
+	uint8_t i, opcode, available;
+	uint16_t need;
+	int	result;
+
+	for (;;) {
+		if (skip > 0) {										// discard the rest of a request which is too long
+			available = usart0inBufferCount();
+
+			if (available == 0) {
+				if ((uint16_t)(timer1Millis() - since) <= PARSETIMEOUT)
+					return;
+				skip = 0;									// line idle, the client sent less than announced
+				continue;
+			}
+
+			for (; available > 0 && skip > 0; available--, skip--)
+				getch();
+			since = timer1Millis();
+			continue;
+		}
+
+		if (command.opcode == 0) {							// wait for an opcode
+			if (usart0inBufferCount() == 0)
+				return;
+
+			opcode = getch();
+
+			if (opcode == XON || opcode == XOFF)			// flow control from the client's serial driver, ignore
+				continue;
+
+			for (i = 0; i < sizeof(commandTable) / sizeof(COMMAND); i++)
+				if (pgm_read_byte(&commandTable[i].opcode) == opcode)
+					break;
+
+			if (i == sizeof(commandTable) / sizeof(COMMAND)) {
+				putch(reqERROR); 							// unknown request, ignore
+				continue;
+			}
+
+			memcpy_P(&command, &commandTable[i], sizeof(COMMAND));
+
+			received = 0;
+			since = timer1Millis();
+		}
+
+		available = usart0inBufferCount();
+
+		need = command.length;
+		if (command.itemLength != 0 && available > 0)
+			need += usart0Peek(0) * command.itemLength;	// the first payload byte holds the number of items
+
+		if (available >= need) {							// the complete payload has arrived
+			result = command.handler();
+			if (result == BUSY) {							// try again later, the request is not stalled
+				received = available;
+				since = timer1Millis();
+				return;
+			}
+			if (command.reply == TRUE)
+				putch(result == ERROR ? reqERROR : reqOK);
+			command.opcode = 0;
+			continue;
+		}
+
+		if (available != received) {						// still receiving
+			received = available;
+			since = timer1Millis();
+		}
+
+		if (need >= RxHighWater || (uint16_t)(timer1Millis() - since) > PARSETIMEOUT) {
+			if (need >= RxHighWater)						// request too long: also discard the bytes still to come
+				skip = need - available;
+			for (; available > 0; available--)				// request too long or client stalled: discard it
+				getch();
+			since = timer1Millis();
+			putch(reqERROR);
+			command.opcode = 0;
+			continue;
+		}
+		return;
+	}
+}
+
+
+/*	Request handlers without a payload of their own.
+ *
+ */
+int startTimer(void)
+{
+	timerEnable = TRUE;
+
+	return OK;
+}
+
+
+int stopTimer(void)
+{
+	timerEnable = FALSE;
+	disableTimeOut = 10;									// the timer will automatically be re-enabled after 10 minutes
+	verbose = FALSE;										// no more need for verbose once the timer has stopped
+
+	return OK;
+}
+
+
+int setVerbose(void)
+{
+	verbose = TRUE;
+
+	trace(TRACE_VERBOSE, 0, 0);								// sent after the reply, as events are only sent when idle
+
+	return OK;
+}
+
+
+int reset(void)
+{
+	// do not use watchdog reset on a mySmartControl; if you do the device will not exit from the bootloader
+	//wdt_enable(WDTO_15MS);								// set watchdog timer to 15mS
+	//WDTCSR = 0x08;
+	for (;;) { }											// wait for user to press reset
+
+	return OK;
+}
+
+
+/*	Send current DS1307 date and time to the client.
+ *
+ *	Message sent (7 bytes):
+ *
+ *	0	day of date (as integer)
+ *	1	month of date (as integer)
+ *	2	year of date (as integer)
+ *	3	weekday of date (as integer)
+ *	4	hours of time (as integer)
+ *	5	minutes of time (as integer)
+ *	6	seconds of time (as integer)
+
+ *	Return: OK when successful, ERROR if date and time could not be retrieved
+ *
+ */
+int getTime()
+{
+	datetime dt;
+
+	if (DS1307GetTime(&dt) == ERROR)
+		return ERROR;
+
+	putch(dt.dd);
+	putch(dt.mm);
+	putch(dt.yy);
+	putch(dt.day);
+	putch(dt.hrs);
+	putch(dt.min);
+	putch(dt.sec);
+
+	return OK;
+}
+
+
+/*	Check the validity of a date and time received from the client.
+ *
+ */
+static boolean validTime(datetime *dt)
+{
+	if (dt->dd < 1 || dt->dd > 31)
+		return FALSE;
+	if (dt->mm < 1 || dt->mm > 12)
+		return FALSE;
+	if (dt->yy > 99)
+		return FALSE;
+	if (dt->day < 1 || dt->day > 7)
+		return FALSE;
+	if (dt->hrs > 23)
+		return FALSE;
+	if (dt->min > 59)
+		return FALSE;
+	if (dt->sec > 59)
+		return FALSE;
+
+	return TRUE;
+}
+
+
+/*	Receive new date and time from client and set the DS1307 internal clock.
+ *	Checks for validity of date and time
+ *
+ *	Message received (7 bytes):
+ *
+ *	0	day of date (as integer)
+ *	1	month of date (as integer)
+ *	2	year of date (as integer)
+ *	3	weekday of date (as integer)
+ *	4	hours of time (as integer)
+ *	5	minutes of time (as integer)
+ *	6	seconds of time (as integer)
+ *
+ *	Return: OK when successful, ERROR if invalid date or time or when DS1307 could not be written
+ *
+ */
+int setTime()
+{
+	datetime dt;
+
+	dt.dd  = getch();
+	dt.mm  = getch();
+	dt.yy  = getch();
+	dt.day = getch();
+	dt.hrs = getch();
+	dt.min = getch();
+	dt.sec = getch();
+
+	if (validTime(&dt) == FALSE)
+		return ERROR;
+
+	if (DS1307SetTime(&dt) == ERROR)
+		return ERROR;
+
+	initActions();											// the clock has moved, so find the next action again
+
+	return OK;
+}
+
+
+/*	Echo a byte from the client together with the millisecond clock.
+ *
+ *	The client repeats this exchange to find the round trip latency of the serial
+ *	link, and to relate the millisecond clock of the device to its own clock.
+ *	See syncTime().
+ *
+ *	Message received (1 byte):
+ *
+ *	0		sequence number (as integer)
+ *
+ *	Message sent (3 bytes):
+ *
+ *	0		sequence number (as integer)
+ *	1-2		timer1Millis() when the request was handled (as 16-bit integer, little-endian)
+ *
+ */
+int echoTime(void)
+{
+	uint8_t	data[3];
+	uint16_t millis;
+
+	data[0] = getch();
+
+	millis = timer1Millis();
+	data[1] = millis & 0xFF;
+	data[2] = millis >> 8;
+
+	usart0WriteBlock(data, 3);
+
+	return OK;
+}
+
+
+/*	Receive date and time from the client and set the DS1307 at a given moment.
+ *
+ *	Unlike setTime() the moment the clock is set does not depend on the latency
+ *	of the serial link. The client sends the date and time of the next whole second
+ *	plus the value of the millisecond clock at that moment, which it calculated with
+ *	echoTime(). The device waits until then and writes the clock. The DS1307 starts
+ *	counting a new second when its seconds register is written. As the main loop
+ *	is blocked while waiting the client must send the request less than
+ *	SYNCMAXWAIT ms before the moment.
+ *
+ *	Message received (9 bytes):
+ *
+ *	0-6		date and time as in setTime()
+ *	7-8		timer1Millis() at which the clock must be set (as 16-bit integer, little-endian)
+ *
+ *	Return: OK when successful, ERROR if invalid date or time, if the moment has already
+ *			passed or is more than SYNCMAXWAIT ms away, or when DS1307 could not be written
+ *
+ */
+int syncTime(void)
+{
+	datetime dt;
+	uint16_t at;
+	int16_t	wait;
+
+	dt.dd  = getch();
+	dt.mm  = getch();
+	dt.yy  = getch();
+	dt.day = getch();
+	dt.hrs = getch();
+	dt.min = getch();
+	dt.sec = getch();
+	at = getch();
+	at |= getch() << 8;
+
+	if (validTime(&dt) == FALSE)
+		return ERROR;
+
+	wait = (int16_t)(at - timer1Millis());
+
+	if (wait < 0 || wait > SYNCMAXWAIT)
+		return ERROR;
+
+	while ((int16_t)(timer1Millis() - at) < 0)
+		;
+
+	if (DS1307SetTime(&dt) == ERROR)
+		return ERROR;
+
+	initActions();											// the clock has moved, so find the next action again
+
+	return OK;
+}
+
+
+/*	Wait for the DS1307 seconds to change, then send the date and time to the client.
+ *
+ *	Together with echoTime() the client uses this to measure the remaining difference
+ *	between its own clock and the DS1307 after a syncTime().
+ *
+ *	Message sent (9 bytes):
+ *
+ *	0-1		timer1Millis() when the seconds changed (as 16-bit integer, little-endian)
+ *	2-8		date and time as in getTime(), all 0 if the date and time could not be
+ *			retrieved or the seconds did not change within TICKMAXWAIT ms
+ *
+ *	Return: OK when successful, else ERROR
+ *
+ */
+int getTick(void)
+{
+	datetime dt;
+	uint8_t	i, data[9], sec;
+	uint16_t start, millis;
+	int result;
+
+	result = DS1307GetTime(&dt);
+
+	sec = dt.sec;
+	start = millis = timer1Millis();
+
+	while (result == OK) {
+		millis = timer1Millis();
+		if ((result = DS1307GetTime(&dt)) == ERROR)
+			break;
+		if (dt.sec != sec)
+			break;
+		if ((uint16_t)(millis - start) > TICKMAXWAIT)
+			result = ERROR;									// the DS1307 is not running
+	}
+
+	data[0] = millis & 0xFF;
+	data[1] = millis >> 8;
+	data[2] = dt.dd;
+	data[3] = dt.mm;
+	data[4] = dt.yy;
+	data[5] = dt.day;
+	data[6] = dt.hrs;
+	data[7] = dt.min;
+	data[8] = dt.sec;
+
+	if (result == ERROR)
+		for (i = 2; i < 9; i++)
+			data[i] = 0;
+
+	usart0WriteBlock(data, 9);
+
+	return result;
+}
+
+
+/*	Retrieve an action from the active schedule and send it to client.
+ *
+ *	Client first sends a 16-bit unsigned integer containing the index of the action to retrieve.
+ *	Server then sends the action content to the client.
+ *
+ *	Message received (2 bytes):
+ *
+ *	0		low byte of index (as integer)
+ *	1		high byte of index (as integer)
+ *
+ *	Message sent (SIZEOF(ACTION) bytes):
+ *
+ *	0-9		content of action
+ *
+ *	Return: OK when successful, ERROR in case of error reading the action from memory.
+ *
+ */
+int getAction()
+{
+	uint16_t index;
+	uint8_t lo, hi, data[sizeof(ACTION)];
+
+	lo = getch();
+	hi = getch();
+
+	index = (hi << 8) | lo;
+
+	if (readAction(index, (ACTION *)&data) == ERROR)
+		return ERROR;
+
+	usart0WriteBlock(data, sizeof(ACTION));
+
+	return OK;
+}
+
+
+/*	Retrieve a range of actions from the active schedule and stream them to the client.
+ *
+ *	The EEPROM is read in chunks of half the transmit buffer. While a chunk is read
+ *	the interrupt routine is still sending the previous one, so the serial line is
+ *	kept busy during the whole transfer.
+ *
+ *	Message received (4 bytes):
+ *
+ *	0		low byte of index of the first action (as integer)
+ *	1		high byte of index of the first action (as integer)
+ *	2		low byte of the number of actions (as integer)
+ *	3		high byte of the number of actions (as integer)
+ *
+ *	At most STREAMMAX actions are sent per request, so the minute task is not
+ *	held up for long; a larger range must be requested in blocks.
+ *
+ *	Message sent (min(number of actions, STREAMMAX) * SIZEOF(ACTION) bytes):
+ *
+ *	0-..	content of the actions, an action which could not be read is sent as all zero's
+ *
+ *	Return: OK when successful, ERROR in case of error reading from memory.
+ *
+ */
+int getActions()
+{
+	uint16_t index, count;
+	uint32_t addr, end, valid;
+	uint8_t i, n, lo, hi, chunk[STREAMCHUNK];
+	int	result = OK, open = FALSE;
+
+	lo = getch();
+	hi = getch();
+	index = (hi << 8) | lo;
+
+	lo = getch();
+	hi = getch();
+	count = (hi << 8) | lo;
+
+	if (count > STREAMMAX)
+		count = STREAMMAX;
+
+	addr  = bankAddress(schedule.bank) + (uint32_t)index * sizeof(ACTION);
+	end   = addr + (uint32_t)count * sizeof(ACTION);
+	valid = bankAddress(schedule.bank + 1);						// addresses beyond the last action are sent as zero's
+
+	if (addr < valid && addr < end) {							// read all chunks in a single sequential read
+		if (storage->readOpen(addr) < 0)
+			result = ERROR;
+		else
+			open = TRUE;
+	}
+
+	for (; addr < end; addr += n) {
+		n = (end - addr) < STREAMCHUNK ? (end - addr) : STREAMCHUNK;
+
+		for (i = 0; i < n; i++)
+			chunk[i] = 0;
+
+		if (open == TRUE && addr < valid)
+			if (storage->readNext((valid - addr) < n ? (valid - addr) : n, chunk) < 0) {
+				result = ERROR;
+				open = FALSE;									// a failed read has already released the bus
+			}
+
+		usart0WriteBlock(chunk, n);
+	}
+
+	if (open == TRUE)
+		storage->readClose();
+
+	return result;
+}
+
+
+/*	Receive an action from the client and store it in the inactive schedule.
+ *
+ *	The new schedule is executed only after it has been activated, see activateSchedule().
+ *	Client first sends a 16-but unsigned integer containing the index of the action,
+  * followed by the content of the action.
+ *
+ *	Message received (2 + SIZEOF(ACTION) bytes):
+ *
+ *	0		low byte of index (as integer)
+ *	1		high byte of index (as integer)
+ *	2-12	content of action
+ *
+ */
+int setAction()
+{
+	uint16_t index;
+	uint8_t lo, hi, data[sizeof(ACTION)];
+
+	lo = getch();
+	hi = getch();
+
+	usart0ReadBlock(data, sizeof(ACTION));
+
+	index = (hi << 8) | lo;
+
+	if (actionCheck((ACTION *)&data) == FALSE)				// garbled on the serial line
+		return ERROR;
+
+	if (writeAction(index, (ACTION *)&data) == ERROR)
+			return ERROR;
+
+	return OK;
+}
+
+
+/*	Receive a command from the client to immediately send to a switch.
+ *
+ *	The signal is put in the transmit queue, and the reply is sent once it is
+ *	queued. While the queue is full the request waits in the receive buffer.
+ *
+ *	Message received (3 bytes):
+ *
+ *	0		major device id (as character, values: 'A' to 'P')
+ * 	1		minor device id (as integer, values: 1 to 16)
+ * 	2		command (as integer, values: 0 or 1 (off / on))
+ *
+ *	Return: OK if parameter values were valid, else ERROR
+ *
+ */
+int switchUnit()
+{
+	uint8_t major, minor, command;
+
+	if (rfPending() == RFQUEUESIZE)
+		return BUSY;
+
+	major   = getch();
+	minor   = getch();
+	command = getch();
+
+	if ((char)major >= 'A' && (char)major <= 'P')
+		if (minor >= 1 && minor <= 16)
+			if (command >= 0 && command <= 1)
+				return rfEnqueue(major, minor, command, RFNOTDUE);
+	return ERROR;
+}
+
+
+/*	Receive a scene from the client and immediately send it to the switches.
+ *
+ *	All units in the scene are put in the transmit queue at once, and are switched
+ *	in a single transmitter burst as far as the airtime budget allows (see rfTask()).
+ *	The reply is sent once they are queued. While the queue has no room for the
+ *	whole scene the request waits in the receive buffer.
+ *
+ *	Message received (1 + count * 3 bytes):
+ *
+ *	0		number of units in the scene (as integer, values: 1 to SCENESIZE)
+ *	1		major device id of 1st unit (as character, values: 'A' to 'P')
+ *	2		minor device id of 1st unit (as integer, values: 1 to 16)
+ *	3		command for 1st unit (as integer, values: 0 or 1 (off / on))
+ *	4-..	major, minor and command of the next units
+ *
+ *	Return: OK if all parameter values were valid, else ERROR
+ *
+ */
+int switchScene()
+{
+	uint8_t	i, count, unit[SCENESIZE * 3];
+	int	result = OK;
+
+	count = usart0Peek(0);
+
+	if (count >= 1 && count <= SCENESIZE && RFQUEUESIZE - rfPending() < count)
+		return BUSY;
+
+	count = getch();
+
+	if (count < 1 || count > SCENESIZE) {
+		for (i = 0; i < count; i++)							// the parser has received the complete payload, discard it
+			usart0ReadBlock(unit, 3);
+		return ERROR;
+	}
+
+	usart0ReadBlock(unit, count * 3);						// always receive the complete message, even if a unit is invalid
+
+	for (i = 0; i < count * 3; i += 3) {
+		if ((char)unit[i] < 'A' || (char)unit[i] > 'P')
+			result = ERROR;
+		if (unit[i+1] < 1 || unit[i+1] > 16)
+			result = ERROR;
+		if (unit[i+2] > 1)
+			result = ERROR;
+	}
+
+	if (result == OK)
+		result = rfEnqueueScene(count, unit);
+
+	return result;
+}
+
+
+/*	Transmit a string with 37 bytes of device info to the client.
+ *
+ *	Message sent (37 bytes):
+ *
+ *	0-2		hardware version (as string)
+ *	3-5		software version (as string)
+ *	6-12	data-memory size (as string)
+ *	13-17	number of valid actions in the active schedule (as string)
+ *	18-22	maximum number of actions in a schedule (as string)
+ *	23-27	generation of the active schedule (as string)
+ *	28-30	layout version of the schedule (as string)
+ *	31		'1' if the CRC over the active schedule matches its header, else '0' (as string)
+ *	32-36	CRC-CCITT over the active schedule from its header (as string)
+ *
+ */
+int getInfo()
+{
+	char buffer[37];
+
+	uint2str(&buffer[0], hardware.version, 3, ' ');			// hardware version as string[3]
+	uint2str(&buffer[3], SOFTWAREVERSION, 3, ' ');			// software version as string[3]
+	uint2str(&buffer[6], hardware.memorySize, 7, '0');		// data-memory size as string[7]
+	uint2str(&buffer[13], schedule.count, 5, '0');			// number of valid actions in the active schedule as string[5]
+	uint2str(&buffer[18], maxActionIndex, 5, '0');			// maximum number of actions in a schedule as string[5]
+	uint2str(&buffer[23], schedule.generation, 5, '0');		// generation of the active schedule as string[5]
+	uint2str(&buffer[28], schedule.version, 3, ' ');		// layout version as string[3]
+	buffer[31] = (scheduleIntact == TRUE) ? '1' : '0';		// result of the last check of the schedule CRC as string[1]
+	uint2str(&buffer[32], schedule.crc, 5, '0');			// CRC of the active schedule as string[5]
+
+	usart0WriteBlock((uint8_t *)buffer, 37);
+
+	return OK;
+}
+
+
+/*	Write system information to the DS1307 memory.
+ *
+ *	Used only by manufacturer to initialize the device.
+ *
+ *	Message received (8 bytes):
+ *
+ *	0		hardware version (as integer, values: 0 to 255)
+ *	1		memory type (as integer, values: 0 for internal EEPROM, 1 for I2C EEPROM;
+ *			for I2C EEPROM the high nibble holds the number of chips - 1)
+ *	2-5		memory size in bytes (of all chips together) (as integer, little-endian (low byte first then high byte, is the AVR GCC standard))
+ *	6		magic number = 0xFE
+ *	7		magic number = 0xAB
+ *
+ */
+int	setInfo(void)
+{
+	uint8_t	data[8];
+
+	usart0ReadBlock(data, 8);
+
+	if (data[6] == 0xFE && data[7] == 0xAB) {				// check magic number as security measure to avoid unintended writes
+		DS1307WriteData(0x08, 6, (uint8_t *)&data[0]);
+
+		cli();
+		// wdt_enable(WDTO_15MS); 							// set watchdog timer to 15mS -> do not use on a mySmartControl
+		for (;;) {}											// basic information has changed, wait for user to press reset
+	}
+	return ERROR;
+}
+
+
+/*	Send the performance counters to the client.
+ *
+ *	Message sent (SIZEOF(STATISTICS) bytes, integers are little-endian):
+ *
+ *	0-1		worst-case duration of a main loop task in milliseconds (as 16-bit integer)
+ *	2		maximum number of signals waiting for transmission (as integer)
+ *	3-4		number of code frames transmitted (as 16-bit integer)
+ *	5-8		total transmitter airtime in milliseconds (as 32-bit integer)
+ *	9-12	airtime saved by the unit configuration in milliseconds (as signed 32-bit integer)
+ *	13-14	number of received bytes lost because the receive buffer was full (as 16-bit integer)
+ *	15-16	number of action reads served from the EEPROM cache (as 16-bit integer)
+ *	17-18	number of cache lines read from the EEPROM (as 16-bit integer)
+ *	19-20	number of times an action record with a wrong CRC was read (as 16-bit integer)
+ *	21-22	index of the last action record found with a wrong CRC (as 16-bit integer)
+ *	23-24	number of complete checks of the active schedule by the scrub task (as 16-bit integer)
+ *	25-26	worst-case duration of a run of the scrub task in milliseconds (as 16-bit integer)
+ *
+ */
+int getStatistics(void)
+{
+	usart0WriteBlock((uint8_t *)&statistics, sizeof(STATISTICS));
+
+	return OK;
+}
+
+
+/*	Send the unit configuration table to the client.
+ *
+ *	Message sent (UNITCONFIGSIZE * SIZEOF(UNITCONFIG) bytes), for every entry:
+ *
+ *	0		unit id (major unit id - 'A' in the high nibble, minor unit id - 1 in the low nibble)
+ *	1		number of code word repeats, 0 if the entry is not used
+ *	2		transmitter turn-on delay in milliseconds
+ *	3		idle time after the code frame in milliseconds
+ *
+ */
+int getUnitConfig(void)
+{
+	usart0WriteBlock((uint8_t *)unitConfig, sizeof(unitConfig));
+
+	return OK;
+}
+
+
+/*	Receive the unit configuration table from the client and store it in EEPROM.
+ *
+ *	Units which are not in the table use REPEATS and TURNONDELAY.
+ *
+ *	Message received (UNITCONFIGSIZE * SIZEOF(UNITCONFIG) bytes): see getUnitConfig()
+ *
+ *	Return: OK, or ERROR if an entry is invalid
+ *
+ */
+int setUnitConfig(void)
+{
+	usart0ReadBlock((uint8_t *)unitConfig, sizeof(unitConfig));
+
+	return unitConfigSave();
+}
+
+
+/*	Send a range of entries of the execution log to the client, oldest entry first.
+ *
+ *	Like getActions() at most STREAMMAX entries are sent per request, so the main
+ *	loop is not held up for long; the whole log is read page by page.
+ *
+ *	Message received (4 bytes):
+ *
+ *	0		low byte of index of the first entry, 0 = oldest (as integer)
+ *	1		high byte of index of the first entry (as integer)
+ *	2		low byte of the number of entries (as integer)
+ *	3		high byte of the number of entries (as integer)
+ *
+ *	Message sent (2 + n * SIZEOF(LOGENTRY) bytes, n = min(number of entries, STREAMMAX,
+ *	entries in the log - index)):
+ *
+ *	0		low byte of the number of entries in the log (as integer)
+ *	1		high byte of the number of entries in the log (as integer)
+ *	2-..	content of the entries, an entry which could not be read is sent as all zero's
+ *
+ *	The parser then sends '1', or '0' if an entry could not be read or the entries
+ *	still in RAM could not be written (they are not sent, and written later).
+ *
+ *	Return: OK when successful, ERROR in case of error reading or writing memory.
+ *
+ */
+int getLog(void)
+{
+	LOGENTRY chunk[STREAMCHUNK / sizeof(LOGENTRY)];
+	uint16_t index, count, end;
+	uint8_t i, n, lo, hi;
+	int	result = OK;
+
+	lo = getch();
+	hi = getch();
+	index = (hi << 8) | lo;
+
+	lo = getch();
+	hi = getch();
+	count = (hi << 8) | lo;
+
+	if (logFlush() == ERROR)								// include the entries which are still in RAM
+		result = ERROR;
+
+	end = logCount();										// only the entries in EEPROM, so never stale ones
+
+	putch(end & 0xFF);
+	putch(end >> 8);
+
+	if (count > STREAMMAX)
+		count = STREAMMAX;
+	if (index < end && end - index > count)
+		end = index + count;
+
+	for (; index < end; index += n) {
+		n = (end - index) < (STREAMCHUNK / sizeof(LOGENTRY)) ? (end - index) : (STREAMCHUNK / sizeof(LOGENTRY));
+
+		if (logRead(index, n, chunk) == ERROR) {
+			for (i = 0; i < sizeof(chunk); i++)
+				((uint8_t *)chunk)[i] = 0;
+			result = ERROR;
+		}
+
+		usart0WriteBlock((uint8_t *)chunk, n * sizeof(LOGENTRY));
+	}
+
+	return result;
+}
+
+
+/*	Send the execution time per profiled function to the client.
+ *
+ *	Only available when compiled with -DPROFILE, else no entries are sent.
+ *
+ *	Message sent (4 + number of entries * SIZEOF(PROFILEENTRY) bytes, integers are little-endian):
+ *
+ *	0		number of entries (as integer, 0 if profiling is not compiled in)
+ *	1		timer0 prescaler, the number of CPU cycles per tick (as integer)
+ *	2-3		ticks measured for an empty PROFILE_ENTER / PROFILE_EXIT pair (as 16-bit integer)
+ *	4-..	per function, in the order of the id's in profile.h:
+ *			number of calls (as 16-bit integer), total, minimum and maximum ticks (as 32-bit integers)
+ *
+ */
+int getProfile(void)
+{
+#ifdef PROFILE
+	putch(PROFILEIDS);
+	putch(PROFILEPRESCALER);
+	usart0WriteBlock((uint8_t *)&profileOverhead, sizeof(profileOverhead));
+	usart0WriteBlock((uint8_t *)profile, sizeof(profile));
+#else
+	putch(0);
+	putch(PROFILEPRESCALER);
+	putch(0);
+	putch(0);
+#endif
+	return OK;
+}
+
+
+/*	Send the SRAM usage to the client.
+ *
+ *	Message sent (SIZEOF(SRAMUSAGE) bytes, integers are little-endian):
+ *
+ *	0-1		bytes used by static variables (as 16-bit integer)
+ *	2-3		deepest stack usage since startup in bytes (as 16-bit integer)
+ *	4-5		bytes free between the static variables and the stack right now (as 16-bit integer)
+ *	6-7		bytes which have never been used since startup (as 16-bit integer)
+ *
+ */
+int getMemory(void)
+{
+	SRAMUSAGE usage;
+
+	sramUsage(&usage);
+
+	usart0WriteBlock((uint8_t *)&usage, sizeof(SRAMUSAGE));
+
+	return OK;
+}
+
+
+/*	Send the last command sent to every unit to the client.
+ *
+ *	Units which never received a command since the DS1307 RAM was initialized are reported as off.
+ *
+ *	Message sent (UNITSTATESIZE = 32 bytes):
+ *
+ *	0-31	one bit per unit, bit ((major - 'A') * 16 + minor - 1) of the 256-bit little-endian bitmap,
+ *			i.e. byte 2 * (major - 'A') holds minor units 1 to 8 and the next byte minor units 9 to 16;
+ *			bit set = on
+ *
+ */
+int getUnitStates(void)
+{
+	usart0WriteBlock(unitState, UNITSTATESIZE);
+
+	return OK;
+}
+
+
+/*	Send the lateness histogram of the executed actions to the client.
+ *
+ *	The lateness of an action is the time between the minute it was due and the
+ *	moment its signal was transmitted. As checkActions() executes the actions of a
+ *	minute on the first minute tick after it, which runs free from the DS1307
+ *	seconds, an action is normally between 60 and 120 seconds late. Signals sent
+ *	by 'G' and 'L' are queued without a lateness and are not counted.
+ *
+ *	Message received (1 byte):
+ *
+ *	0		1 = clear the histogram after sending it, 0 = keep it (as integer)
+ *
+ *	Message sent (SIZEOF(LATENESS) bytes, integers are little-endian):
+ *
+ *	0-3		largest lateness in ms (as 32-bit integer)
+ *	4-..	LATENESSBUCKETS counters, number of actions with 0-10 s, 10-20 s, .. of lateness
+ *			(LATENESSWIDTH seconds per counter); the last counter includes all later
+ *			actions (as 16-bit integers)
+ *
+ */
+int getLateness(void)
+{
+	uint8_t	i, clear;
+
+	clear = getch();
+
+	usart0WriteBlock((uint8_t *)&lateness, sizeof(LATENESS));
+
+	if (clear == 1) {
+		lateness.max = 0;
+		for (i = 0; i < LATENESSBUCKETS; i++)
+			lateness.count[i] = 0;
+	}
+
+	return OK;
+}
+
+
+/*	Make the schedule which was written by setAction() the active one.
+ *
+ *	The new schedule is counted and its CRC calculated once, then only the header
+ *	is written, so the switch-over is immediate and the timer keeps on running.
+ *	The previously active bank becomes available for the next upload.
+ *
+ *	Return: OK, or ERROR when the new schedule could not be read, contains a corrupt
+ *			action or has a timed action after a sun relative one (the current schedule
+ *			stays active), or the header could not be written
+ *
+ */
+int activateSchedule(void)
+{
+	SCHEDULE header;
+	int	count;
+
+	header.version = SOFTWAREVERSION;
+	header.bank = schedule.bank ^ 1;
+	header.generation = schedule.generation + 1;
+
+	if ((count = countActions(header.bank, &header.crc, &header.timed)) == ERROR)
+		return ERROR;
+
+	header.count = count;
+
+	if (scheduleSave(&header) == ERROR)
+		return ERROR;
+
+	schedule = header;
+	scheduleIntact = TRUE;									// just counted
+
+	initActions();
+
+	return OK;
+}
+
+
+/*	Load the schedule header from AVR EEPROM.
+ *
+ *	Of the two copies the valid one with the highest generation is used. If neither
+ *	copy is valid (like in erased EEPROM) the timer starts with an empty schedule.
+ *
+ */
+void scheduleLoad(void)
+{
+	SCHEDULE header;
+	uint8_t i;
+
+	schedule.version = 0;
+
+	for (i = 0; i < 2; i++) {
+		eeprom_read_block(&header, &scheduleEeprom[i], sizeof(SCHEDULE));
+		if (header.version != SOFTWAREVERSION || header.bank > 1)
+			continue;
+		if (schedule.version != SOFTWAREVERSION || (int16_t)(header.generation - schedule.generation) > 0)
+			schedule = header;
+	}
+
+	if (schedule.version != SOFTWAREVERSION) {				// no (valid) header: start with an empty schedule
+		schedule.version = SOFTWAREVERSION;
+		schedule.bank = 0;
+		schedule.generation = 0;
+		schedule.count = 0;
+		schedule.crc = 0xFFFF;
+		schedule.timed = 0;
+	}
+}
+
+
+/*	Store the schedule header in AVR EEPROM.
+ *
+ *	The header is written to the copy which does not hold the current header. The
+ *	version is cleared first and written last, so an interrupted write leaves an
+ *	invalid copy and the current header remains in use.
+ *
+ *	Return: OK
+ *
+ */
+int	scheduleSave(SCHEDULE *header)
+{
+	SCHEDULE *copy = &scheduleEeprom[header->generation & 1];
+
+	eeprom_update_byte(&copy->version, 0);
+	eeprom_update_block((uint8_t *)header + 1, (uint8_t *)copy + 1, sizeof(SCHEDULE) - 1);
+	eeprom_update_byte(&copy->version, header->version);
+
+	return OK;
+}
+
+
+/*	Check the active schedule against the count and CRC in its header.
+ *
+ *	Return: TRUE if they match (or the schedule is empty), else FALSE
+ *
+ */
+boolean scheduleVerify(void)
+{
+	uint16_t crc, timed;
+
+	if (schedule.count == 0)
+		return TRUE;
+
+	if (countActions(schedule.bank, &crc, &timed) != schedule.count)
+		return FALSE;
+
+	return (crc == schedule.crc && timed == schedule.timed) ? TRUE : FALSE;
+}
+
+
+/*	Initialize action counter to position based on the current time.
+ *
+ */
+void initActions(void)
+{
+	datetime dt;
+
+	DS1307GetTime(&dt);
+
+	prev = dt.hrs * 60 + dt.min;
+	checkTo = 0;											// forget an interval which could not be finished
+
+	positionActions(prev);
+}
+
+
+/*	Position the action counter at the first action due at or after minute.
+ *
+ *	The actions in a schedule are sorted on time, so a binary search finds the
+ *	position with log2(number of actions) EEPROM reads.
+ *
+ *	minute	minutes since 00:00
+ *
+ */
+void positionActions(int minute)
+{
+	ACTION a;
+	uint16_t low, high, mid;
+
+	low  = 0;
+	high = schedule.timed;
+
+	while (low < high) {									// invariant: actions before low are due before minute, from high on at or after
+		mid = (low + high) / 2;
+		if (readAction(mid, &a) == ERROR)
+			break;
+		if (a.hrs * 60 + a.min < minute)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	next = (low < schedule.timed) ? low : 0;				// all actions are due before minute: wrap around to the top
+
+	if (verbose == TRUE)
+		trace(TRACE_POSITION, &next, sizeof(next));
+}
+
+
+/*	Check if time has passed between the previous and the current call of this function,
+ *	and if so then execute any action in between.
+ *
+ *	The actions are only queued, rfTask() transmits them. When the transmit queue
+ *	is full the check stops at the first action which could not be queued (next or
+ *	sunNext) and the end of the interval is kept in checkTo. transmitTask() calls
+ *	this function again once signals have been sent, and the check continues where
+ *	it stopped. A new interval is only started when the previous one is finished.
+ *
+ */
+void checkActions(void)
+{
+	static boolean timedDone;								// TRUE if the timed actions of interval checkTo have been queued
+	int	curr;
+	datetime dt;
+
+	PROFILE_ENTER(PROFILE_CHECKACTIONS);
+
+	DS1307GetTime(&dt);
+
+	if (verbose == TRUE) {
+		uint8_t t[7] = { dt.dd, dt.mm, dt.yy, dt.day, dt.hrs, dt.min, dt.sec };
+		trace(TRACE_CHECK, t, sizeof(t));
+	}
+
+	curr = dt.hrs * 60 + dt.min;
+
+	for (;;) {
+		if (checkTo == 0) {
+			if (curr == prev) 								// no time passed between now and previous call
+				break;
+			checkTo = (curr > prev) ? curr : 24*60;			// new call earlier then previous call: first finish the day
+			timedDone = FALSE;
+			sunNext = 0;
+		}
+
+		if (timedDone == FALSE && executeActions(prev, checkTo, &dt) == ERROR)
+			break;											// transmit queue full, continue later
+		timedDone = TRUE;
+
+		if (executeSunActions(prev, checkTo, &dt) == ERROR)
+			break;
+
+		prev = (checkTo == 24*60) ? 0 : checkTo;			// interval finished, check the rest (after midnight)
+		checkTo = 0;
+	}
+
+	logFlush();												// write the log entries of this check to EEPROM
+
+	PROFILE_EXIT(PROFILE_CHECKACTIONS);
+}
+
+
+/*	Check if an action applies to the date in dt.
+ *
+ *	today = day number of dt
+ *
+ */
+static boolean actionToday(ACTION *a, datetime *dt, uint16_t today)
+{
+	if (a->day != 0 && a->day != dt->day)					// Are we on the right weekday (if weekday is relevant)?
+		return FALSE;
+
+	if (a->valid == ACTIONRANGE)							// Are we in the range of dates? (a day before the first wraps around)
+		return (uint16_t)(today - ((RANGEACTION *)a)->first) <= ((RANGEACTION *)a)->days ? TRUE : FALSE;
+
+	if (a->dd == 0 || a->mm == 0 || (a->dd == dt->dd && a->mm == dt->mm && a->yy == dt->yy))	// Are we on the right date (if date is relevant)?
+		return TRUE;
+
+	return FALSE;
+}
+
+
+/*	Queue an action for transmission and log it.
+ *
+ *	time = minute at which the action was due
+ *
+ *	The caller has checked that the transmit queue has room. The lateness is taken
+ *	at this moment, so an action which had to wait for room counts as later.
+ *
+ *	Return: TRUE if the log buffer is full and must be written with logFlush()
+ *
+ */
+static boolean queueAction(ACTION *a, int time, datetime *dt)
+{
+	int	late;
+	uint8_t	seconds;
+
+	if (verbose == TRUE) {
+		uint8_t t[3] = { a->major, a->minor, a->cmd };
+		trace(TRACE_ACTION, t, sizeof(t));
+	}
+
+	late = dt->hrs * 60 + dt->min - time;					// Minutes since the action was due (it may be yesterday's).
+	if (late < 0)
+		late += 24*60;
+
+	if (late > LATEREPORTMAX)								// Seconds since the action was due, for the histogram and the log.
+		seconds = RFNOTDUE;
+	else
+		seconds = late * 60 + dt->sec;
+
+	rfEnqueue(a->major, a->minor, a->cmd, seconds);			// Queue the action for execution.
+
+	return logAction(dt, a->major, a->minor, a->cmd, seconds);
+}
+
+
+/*	Execute actions inside time interval
+ *
+ *	Time interval (from, to) expressed as minutes since 00:00
+ *
+ *	from = inclusive
+ *	to 	 = exclusive
+ *
+ *	dt = current date, weekday and time
+ *
+ *	The interval never crosses midnight (see checkActions()), so the check ends at
+ *	the end of the list.
+ *
+ *	Return: ERROR if the transmit queue is full, next is then the first action which
+ *			was not queued, else OK
+ *
+ */
+int executeActions(int from, int to, datetime *dt)
+{
+	ACTION a;
+	int	time;
+	int	first;
+	int	open = FALSE;
+	int	result = OK;
+	uint16_t today;
+
+	PROFILE_ENTER(PROFILE_EXECUTEACTIONS);
+
+	if (verbose == TRUE) {
+		int t[2] = { from, to };
+		trace(TRACE_EXECUTE, t, sizeof(t));
+	}
+
+	if (schedule.timed == 0) {								// The list is empty.
+		PROFILE_EXIT(PROFILE_EXECUTEACTIONS);
+		return OK;
+	}
+
+	if (next >= schedule.timed)								// The list has been replaced by a shorter one.
+		next = 0;
+
+	today = dayNumber(dt->dd, dt->mm, dt->yy);				// Date ranges are checked with a single comparison.
+
+	first = next;
+
+	do {
+		if (open == FALSE && next == first) {				// The head action is usually not yet due, so ...
+			if (readAction(next, &a) == ERROR)				// ... load it via the cache to avoid an EEPROM read every minute.
+				break;
+		} else {
+			if (open == FALSE) {							// Read the remaining actions from EEPROM in one sequential read.
+				if (openActions(schedule.bank, next) == ERROR)
+					break;
+				open = TRUE;
+			}
+			if (nextAction(&a) == ERROR) {					// Load the next action from EEPROM.
+				open = FALSE;								// (the bus has already been released)
+				break;
+			}
+		}
+
+		if (actionCheck(&a) == FALSE)						// A corrupt entry is reported and skipped.
+			actionCorrupt(next);
+		else if (a.valid == ACTIONDATE || a.valid == ACTIONRANGE) {	// An invalid entry is skipped.
+			time = a.hrs * 60 + a.min;						// Minute at which action should run
+
+			if (verbose == TRUE) {
+				int t[2] = { next, time };
+				trace(TRACE_DUE, t, sizeof(t));
+			}
+
+			if (time < from || time >= to)					// Is the time the action should run outside the interval?
+				break;
+
+			if (actionToday(&a, dt, today) == TRUE) {
+				if (rfPending() == RFQUEUESIZE) {			// No room to queue the action, stop here and ...
+					result = ERROR;							// ... continue once signals have been sent.
+					break;
+				}
+				if (queueAction(&a, time, dt) == TRUE) {
+					if (open == TRUE) {						// The log must be written, but not while the sequential read ...
+						closeActions();						// ... is busy on the bus; it is reopened for the next action.
+						open = FALSE;
+					}
+					logFlush();
+				}
+			}
+		}
+		next += 1;											// Goto the next action to execute.
+		if (next == schedule.timed) {						// If we are at the end of the list ...
+			next = 0;										// ... then wrap around to the top, ...
+			break;											// ... where tomorrow's actions start.
+		}
+	} while (next != first); 								// Avoid looping (in case of list with single entry)
+
+	if (open == TRUE)
+		closeActions();
+
+	PROFILE_EXIT(PROFILE_EXECUTEACTIONS);
+
+	return result;
+}
+
+
+/*	Execute sun relative actions inside time interval
+ *
+ *	Time interval (from, to) expressed as minutes since 00:00, see executeActions().
+ *
+ *	The time of these actions changes every day, so they can not be kept in the sorted
+ *	list. They are few, and all of them are checked: the time of each is resolved with
+ *	a single lookup in the sun table. An action whose offset moves it past midnight is
+ *	not executed.
+ *
+ *	The check starts at sunNext, so a check of the same interval which was stopped
+ *	by a full transmit queue continues with the action which could not be queued.
+ *
+ *	Return: ERROR if the transmit queue is full, else OK
+ *
+ */
+int executeSunActions(int from, int to, datetime *dt)
+{
+	ACTION a;
+	uint16_t today;
+	int	time, sunrise, sunset;
+	int	open = FALSE;
+
+	if (schedule.timed >= schedule.count)					// No sun relative actions.
+		return OK;
+
+	if (sunNext < schedule.timed)
+		sunNext = schedule.timed;
+
+	today = dayNumber(dt->dd, dt->mm, dt->yy);
+	sunrise = sunTime(SUNRISE, dt);
+	sunset = sunTime(SUNSET, dt);
+
+	for (; sunNext < schedule.count; sunNext++) {
+		if (open == FALSE) {
+			if (openActions(schedule.bank, sunNext) == ERROR)
+				return OK;
+			open = TRUE;
+		}
+		if (nextAction(&a) == ERROR)						// (the bus has already been released)
+			return OK;
+
+		if (actionCheck(&a) == FALSE) {
+			actionCorrupt(sunNext);
+			continue;
+		}
+
+		if (a.valid != ACTIONSUNRISE && a.valid != ACTIONSUNSET)
+			continue;
+
+		time = (a.valid == ACTIONSUNRISE ? sunrise : sunset) + ((SUNACTION *)&a)->offset;
+
+		if (verbose == TRUE) {
+			int t[2] = { sunNext, time };
+			trace(TRACE_DUE, t, sizeof(t));
+		}
+
+		if (time < from || time >= to)						// Is the time the action should run outside the interval?
+			continue;
+
+		if (actionToday(&a, dt, today) == FALSE)
+			continue;
+
+		if (rfPending() == RFQUEUESIZE) {					// No room to queue the action, continue here later.
+			closeActions();
+			return ERROR;
+		}
+
+		if (queueAction(&a, time, dt) == TRUE) {
+			closeActions();									// The log must be written, but not while the sequential read is busy.
+			open = FALSE;
+			logFlush();
+		}
+	}
+
+	if (open == TRUE)
+		closeActions();
+
+	return OK;
+}
+
+
+/*	Count the number of valid actions in a schedule bank and calculate their CRC.
+ *	Also finds the number of actions with a fixed time, which precede the sun relative ones.
+ *
+ *	The end of the schedule is a record with valid == 0 and a correct CRC of its own,
+ *	so a corrupted valid byte does not silently cut the schedule short.
+ *
+ *	Return: count, or ERROR in case of EEPROM read-error, a corrupt action or an action
+ *			with a fixed time after a sun relative one (it would never be executed)
+ *
+ */
+int countActions(uint8_t bank, uint16_t *crc, uint16_t *timed)
+{
+	ACTION action;
+	int	count = 0;
+	uint8_t	i;
+	boolean	sun = FALSE;
+
+	*crc = 0xFFFF;
+	*timed = 0;
+
+	if (openActions(bank, 0) == ERROR)
+		return ERROR;
+
+	for (count = 0; count < maxActionIndex; count++) {
+		if (nextAction(&action) == ERROR)
+			return ERROR;									// the bus has already been released
+		if (actionCheck(&action) == FALSE) {
+			closeActions();
+			return ERROR;
+		}
+		if (action.valid == 0)
+			break;
+		if (action.valid == ACTIONDATE || action.valid == ACTIONRANGE) {	// the sun relative actions follow the timed ones
+			if (sun == TRUE) {
+				closeActions();
+				return ERROR;
+			}
+			*timed = count + 1;
+		}
+		if (action.valid == ACTIONSUNRISE || action.valid == ACTIONSUNSET)
+			sun = TRUE;
+		for (i = 0; i < sizeof(ACTION); i++)
+			*crc = _crc_ccitt_update(*crc, ((uint8_t *)&action)[i]);
+	}
+
+	closeActions();
+
+	return count;
+}
+
+
+/*	Read the action at position index from the active schedule in EEPROM.
+ *
+ *	Return: OK or ERROR (in case if invalid index or EEPROM read-error)
+ *
+ */
+int	readAction(uint16_t index, ACTION *action)
+{
+	if (index < maxActionIndex)
+		if (storage->readData(bankAddress(schedule.bank) + (uint32_t)index * sizeof(ACTION), sizeof(ACTION), (uint8_t *)action) == sizeof(ACTION))
+			return OK;
+
+	return ERROR;
+}
+
+
+/*	Start a sequential read of the actions in a bank, beginning at position index.
+ *
+ *	Only the first action costs the address and select phase on the I2C bus,
+ *	every following nextAction() just continues the same read transaction.
+ *	A successful open must be followed by closeActions().
+ *
+ *	Return: OK or ERROR (in case of invalid index or EEPROM read-error)
+ *
+ */
+int	openActions(uint8_t bank, uint16_t index)
+{
+	if (index < maxActionIndex)
+		if (storage->readOpen(bankAddress(bank) + (uint32_t)index * sizeof(ACTION)) == 0)
+			return OK;
+
+	return ERROR;
+}
+
+
+/*	Read the next action of a sequential read.
+ *
+ *	Return: OK or ERROR (in case of EEPROM read-error, the read is then closed)
+ *
+ */
+int	nextAction(ACTION *action)
+{
+	if (storage->readNext(sizeof(ACTION), (uint8_t *)action) == sizeof(ACTION))
+		return OK;
+
+	return ERROR;
+}
+
+
+/*	End a sequential read of actions.
+ *
+ */
+void closeActions(void)
+{
+	storage->readClose();
+}
+
+
+/*	Write action to the inactive schedule in EEPROM at position index.
+ *
+ *	The record marking the end of the schedule (valid == 0) is written completely
+ *	as well, as its CRC is checked by countActions().
+ *
+ *	Return: OK or ERROR (in case of invalid index or EEPROM write-error)
+ *
+ */
+int	writeAction(uint16_t index, ACTION *action)
+{
+	uint32_t addr;
+
+	addr = bankAddress(schedule.bank ^ 1) + (uint32_t)index * sizeof(ACTION);
+
+	if (index < maxActionIndex)
+		if (storage->writeData(addr, sizeof(ACTION), (uint8_t *)action) == sizeof(ACTION))
+			return OK;
+
+	return ERROR;
+}
+
+
+/*	Check the CRC of an action record.
+ *
+ *	The CRC-8 (polynomial x^8 + x^2 + x + 1) is calculated by the client over all
+ *	bytes but the last, starting with ACTIONCRC.
+ *
+ *	Return: TRUE if the record is intact, else FALSE
+ *
+ */
+boolean actionCheck(ACTION *action)
+{
+	uint8_t	i, crc = ACTIONCRC;
+
+	for (i = 0; i < sizeof(ACTION) - 1; i++)
+		crc = _crc8_ccitt_update(crc, ((uint8_t *)action)[i]);
+
+	return (crc == action->crc) ? TRUE : FALSE;
+}
+
+
+/*	Report a corrupt action record in the active schedule.
+ *
+ *	The action is not executed. The client finds the number of corrupt records and
+ *	the position of the last one in the statistics.
+ *
+ */
+void actionCorrupt(uint16_t index)
+{
+	if (statistics.actionErrors < 0xFFFF)
+		statistics.actionErrors++;
+	statistics.actionErrorLast = index;
+
+	if (verbose == TRUE)
+		trace(TRACE_CORRUPT, &index, sizeof(index));
+}
@@ -0,0 +1,104 @@
+/*	profile.c
+ *
+ *	Measure the execution time of firmware functions.
+ *
+ *	Timer0 runs freely with a prescaler of 8. Together with the number of
+ *	overflows counted by its interrupt routine this gives a 24-bit clock with a
+ *	resolution of 8 CPU cycles, which wraps around after 6.7 seconds at 20 MHz.
+ *	PROFILE_ENTER stores the clock per function id, PROFILE_EXIT adds the time
+ *	passed to the function's record. Times are inclusive: the time spent in a
+ *	profiled function called by another one is counted for both. The time of
+ *	the overflow interrupt (about 1.5% of the CPU) is included as well.
+ *
+ *	The records are read by the client with request 'S' (see client/profiler.py).
+ *	Only compiled in when PROFILE is defined.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifdef PROFILE
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "profile.h"
+
+PROFILEENTRY profile[PROFILEIDS];		// time spent per function
+uint16_t profileOverhead;				// ticks measured for an empty PROFILE_ENTER / PROFILE_EXIT pair
+
+static uint32_t start[PROFILEIDS];		// clock at the last entry per function
+static volatile uint16_t overflows;		// high part of the clock
+
+
+ISR(TIMER0_OVF_vect)
+{
+	overflows++;
+}
+
+
+/*	Read the 24-bit clock.
+ *
+ */
+static uint32_t profileClock(void)
+{
+	uint16_t high;
+	uint8_t count, sreg;
+
+	sreg = SREG;
+	cli();
+	count = TCNT0;
+	high = overflows;
+	if ((TIFR0 & (1<<TOV0)) && count < 128)			// overflow occurred but interrupt is not yet handled
+		high++;
+	SREG = sreg;
+
+	return ((uint32_t)high << 8) | count;
+}
+
+
+/*	Start timer0 and measure the cost of profiling itself, which the client
+ *	subtracts from every call.
+ *
+ */
+void profileInit(void)
+{
+	uint8_t i;
+
+	TCCR0A = 0;										// normal mode
+	TCCR0B = (1<<CS01);								// prescaler 8
+	TIMSK0 = (1<<TOIE0);							// enable overflow interrupt
+
+	profileEnter(0);
+	profileExit(0);
+
+	profileOverhead = profile[0].total;
+
+	for (i = 0; i < PROFILEIDS; i++) {
+		profile[i].calls = 0;
+		profile[i].total = 0;
+		profile[i].min = 0xFFFFFFFF;
+		profile[i].max = 0;
+	}
+}
+
+
+void profileEnter(uint8_t id)
+{
+	start[id] = profileClock();
+}
+
+
+void profileExit(uint8_t id)
+{
+	uint32_t t;
+	PROFILEENTRY *p = &profile[id];
+
+	t = (profileClock() - start[id]) & 0x00FFFFFF;	// the clock is 24 bits wide
+
+	p->calls++;
+	p->total += t;
+	if (t < p->min)
+		p->min = t;
+	if (t > p->max)
+		p->max = t;
+}
+
+#endif /* PROFILE */
@@ -0,0 +1,55 @@
+/*	profile.h
+ *
+ *	Defines for measuring the execution time of firmware functions
+ *
+ *	Profiling is only compiled in when PROFILE is defined (-DPROFILE), else the
+ *	PROFILE_ENTER and PROFILE_EXIT macros are empty and cost nothing.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _PROFILE_
+#define _PROFILE_
+
+#include <stdint.h>
+
+/*	Id's of the profiled functions, keep in sync with client/profiler.py.
+ *
+ */
+#define PROFILE_CHECKACTIONS	0
+#define PROFILE_EXECUTEACTIONS	1
+#define PROFILE_I2CREADDATA		2
+#define PROFILE_BCD2INT			3
+#define PROFILE_SENDSIGNAL		4
+
+#define PROFILEIDS				5		// number of profiled functions
+
+#define PROFILEPRESCALER		8		// timer0 prescaler, so one tick is 8 CPU cycles
+
+typedef struct							// profile record layout, all times in timer0 ticks
+{
+	uint16_t calls;						// number of times the function was called
+	uint32_t total;						// total time spent in the function
+	uint32_t min;						// shortest call
+	uint32_t max;						// longest call
+} PROFILEENTRY;
+
+#ifdef PROFILE
+
+extern PROFILEENTRY profile[PROFILEIDS];
+extern uint16_t profileOverhead;
+
+#define PROFILE_ENTER(id)	profileEnter(id)
+#define PROFILE_EXIT(id)	profileExit(id)
+
+void profileInit(void);
+void profileEnter(uint8_t id);
+void profileExit(uint8_t id);
+
+#else
+
+#define PROFILE_ENTER(id)
+#define PROFILE_EXIT(id)
+
+#endif /* PROFILE */
+
+#endif /* _PROFILE_ */
@@ -1,196 +1,675 @@
-/*	remote.c
- *
- *	Transmit an RF command signal to a remote unit
- *
- *	The protocol used is the software implementation
- *	of the PT2262 Remote Control Encoder chip. The PT2262
- *	transmits bits in multiples of a fixed period.
- *
- *		1 period (p) = 90 microseconds
- *
- *	A PT2262 input pin can be high, low or floating. Every
- *	value can be transmitted.
- *
- *		Low		4pH, 12pL, 4pH, 12pL
- *		High	12pH, 4pL, 12pH, 4pL
- *		Float	4pH, 12pL, 12pH, 4pL
- *
- *	Every transmission is ended by a synchronisation-bit
- *
- *		Sync	4pH, 124pL
- *
- *	The PT2262 always sends 12 bits. This is a code-word.
- *
- *		Code-word = 12 data bits + sync bit
- *
- *	There is no two-way communication so to make sure a
- *	code-word arrives it is repeated a several times.
- *	This is called a code-frame.
- *
- *		Code-frame = 4 timer a code-word
- *
- *	-- KlikAanKlikUit Protocol --
- *
- *	High is sent as a floating code-bit.
- *	Low is sent a a low code-bit.
- *
- *	A code-word looks like this:
- *
- *		code bits 1 – 4		major unit id, 0 - 15
- *		code bits 5 – 8		minor unit id, 0 - 15
- *		code bit 9			fixed value : Low
- *		code bit 10			fixed value : Float
- *		code bit 11			fixed value : Float
- *		code bit 12			on = Float, off = Low
- *
- *	2009	K.W.E. de Lange
- */
-#include <util/delay.h>
-#include <avr/io.h>
-#include "utility.h"
-
-
-#define	RFPORT	PORTB								// RF transmitter connected to this port
-#define	RFBIT	PB0									// RF transmitter input pin
-#define	XMBIT	PB1									// RF transmitter power on/off pin
-
-#define DELAY_MICROSECONDS	375						// Time length of a single code bit (in micro-seconds)
-#define	REPEATS				4						// Number of times code word is repeated within a code frame
-
-typedef enum { LOW = 0, HIGH, FLOAT } input_t;		// All possible values for a code bit
-
-static input_t bit[12];								// All the bits which make up a code word
-
-
-/*	Send a signal to a unit
- *
- *	major	major unit id (character A,B,..,P)
- *	minor	minor unit id (integer 1,..,16)
- *	command	ON = 1 or OFF = 0
- *
- */
-void sendSignal(uint8_t major, uint8_t minor, uint8_t command)
-{
-	void sendCodeFrame();
-	uint8_t	i;
-
-	major -= 'A';									// major unit id numbers starts at 0
-	minor -= 1;										// minor unit id numbers starts at 0
-
-	for (i = 0; i < 4; i++) {
-		bit[i] = (major & 0x01) ? FLOAT : LOW;		// bits 0-3 contain major unit id (2^4 = 16 major units)
-		major = major >> 1;
-	}
-
-	for (i = 4; i < 8; i++) {
-		bit[i] = (minor & 0x01) ? FLOAT : LOW;		// bits 4-7 contain minor unit id (2^4 = 16 minor units)
-		minor = minor >> 1;
-    }
-
-	bit[8] = LOW;									// bits 8-10 contain fixed values
-	bit[9] = FLOAT;
-	bit[10]= FLOAT;
-	bit[11]= (command ? FLOAT : LOW);				// bit 11 contains the command = switch unit on or off
-
-	sendCodeFrame();
-}
-
-
-/*	Send code frame
- *
- *	Frame consists of a code word repeated X times
- *
- */
-void sendCodeFrame()
-{
-	void sendCodeWord();
-	uint8_t i;
-
-	bitSet(RFPORT,(1<<XMBIT));						// switch transmitter on
-	_delay_ms(2); 									// turn-on delay
-
-	for (i = 0; i < REPEATS; i++)					// repeat code word multiple times
-		sendCodeWord();
-
-	bitClr(RFPORT, (1<<XMBIT));						// switch transmitter off
-}
-
-
-/*	Send a 12-bit code word plus single sync bit
- *
- *	Code bits are stored in array bit[]
- *
- */
-void sendCodeWord()
-{
-	void sendCodeBit(input_t);
-	void sendSyncBit();
-	uint8_t	i;
-
-	for (i = 0; i < 12; i++)						// code word contains 12 bits
-		sendCodeBit(bit[i]);
-
-	sendSyncBit();
-}
-
-
-/*	Transmit a single code bit
- *
- *	Format (one period per bit):
- *
- *	Low		1 0 0 0 1 0 0 0
- *	High	1 1 1 0 1 1 1 0
- *	Float	1 0 0 0 1 1 1 0
- */
-void sendCodeBit(input_t bit)
-{
-	switch (bit) {
-		case LOW:
-			bitSet(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS);
-			bitClr(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS * 3);
-			bitSet(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS);
-			bitClr(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS * 3);
-			break;
-		case HIGH:
-			bitSet(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS * 3);
-			bitClr(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS);
-			bitSet(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS * 3);
-			bitClr(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS);
-			break;
-		case FLOAT:
-			bitSet(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS);
-			bitClr(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS * 3);
-			bitSet(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS * 3);
-			bitClr(RFPORT, (1<<RFBIT));
-			_delay_us(DELAY_MICROSECONDS);
-			break;
-	}
-}
-
-
-/*	Transmit synchronization signal
- *
- *	Format (one period per bit)
- *
- *	1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0
- *
- * 	(equals 1 x H and 31 x 0)
- */
-void sendSyncBit()
-{
-	bitSet(RFPORT, (1<<RFBIT));
-	_delay_us(DELAY_MICROSECONDS);
-	bitClr(RFPORT, (1<<RFBIT));
-	_delay_us(DELAY_MICROSECONDS * 31);
-}
+/*	remote.c
+ *
+ *	Transmit an RF command signal to a remote unit
+ *
+ *	The protocol used is the software implementation
+ *	of the PT2262 Remote Control Encoder chip. The PT2262
+ *	transmits bits in multiples of a fixed period.
+ *
+ *		1 period (p) = 90 microseconds
+ *
+ *	A PT2262 input pin can be high, low or floating. Every
+ *	value can be transmitted.
+ *
+ *		Low		4pH, 12pL, 4pH, 12pL
+ *		High	12pH, 4pL, 12pH, 4pL
+ *		Float	4pH, 12pL, 12pH, 4pL
+ *
+ *	Every transmission is ended by a synchronisation-bit
+ *
+ *		Sync	4pH, 124pL
+ *
+ *	The PT2262 always sends 12 bits. This is a code-word.
+ *
+ *		Code-word = 12 data bits + sync bit
+ *
+ *	There is no two-way communication so to make sure a
+ *	code-word arrives it is repeated a several times.
+ *	This is called a code-frame.
+ *
+ *		Code-frame = 4 timer a code-word
+ *
+ *	The number of repeats and the guard times around a code-frame
+ *	can be configured per unit, see unitConfig[].
+ *
+ *	-- KlikAanKlikUit Protocol --
+ *
+ *	High is sent as a floating code-bit.
+ *	Low is sent a a low code-bit.
+ *
+ *	A code-word looks like this:
+ *
+ *		code bits 1 – 4		major unit id, 0 - 15
+ *		code bits 5 – 8		minor unit id, 0 - 15
+ *		code bit 9			fixed value : Low
+ *		code bit 10			fixed value : Float
+ *		code bit 11			fixed value : Float
+ *		code bit 12			on = Float, off = Low
+ *
+ *	The last command sent to every unit is remembered in a bitmap,
+ *	which is mirrored in the battery backed RAM of the DS1307.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include <util/delay.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include "define.h"
+#include "utility.h"
+#include "remote.h"
+#include "statistics.h"
+#include "event.h"
+#include "profile.h"
+#include "ds1307.h"
+
+
+#define	RFPORT	PORTB								// RF transmitter connected to this port
+#define	RFBIT	PB0									// RF transmitter input pin
+#define	XMBIT	PB1									// RF transmitter power on/off pin
+
+
+typedef enum { LOW = 0, HIGH, FLOAT } input_t;		// All possible values for a code bit
+
+static input_t bit[12];								// All the bits which make up a code word
+
+typedef struct										// Signal waiting to be transmitted
+{
+	uint8_t	major;
+	uint8_t	minor;
+	uint8_t	command;
+	uint8_t	late;									// seconds the action was already late when queued, RFNOTDUE if not an action
+	uint16_t queued;								// timer1Millis() when queued
+} SIGNAL;
+
+static SIGNAL queue[RFQUEUESIZE];					// Signals waiting to be transmitted
+static uint8_t queueHead, queueCount;
+
+UNITCONFIG unitConfig[UNITCONFIGSIZE];				// Unit configuration, cached copy of the table in EEPROM
+static UNITCONFIG unitConfigEeprom[UNITCONFIGSIZE] EEMEM;
+
+static const UNITCONFIG unitDefault = { 0, REPEATS, TURNONDELAY, 0 };	// Configuration for all units not in the table
+
+uint8_t unitState[UNITSTATESIZE];					// Last command sent to each unit, bit ((major - 'A') * 16 + minor - 1)
+static uint32_t unitStateDirty;						// Bytes of unitState[] which differ from the copy in DS1307 RAM, one bit per byte
+#if UNITREFRESH
+static uint8_t unitKnown[UNITSTATESIZE];			// Units which have received a command since startup
+#endif
+
+
+/*	Send a signal to a unit
+ *
+ *	major	major unit id (character A,B,..,P)
+ *	minor	minor unit id (integer 1,..,16)
+ *	command	ON = 1 or OFF = 0
+ *
+ *	Return: time in ms the transmission took
+ *
+ */
+uint16_t sendSignal(uint8_t major, uint8_t minor, uint8_t command)
+{
+	const UNITCONFIG *unitConfigFind(uint8_t, uint8_t);
+	void encodeCodeWord(uint8_t, uint8_t, uint8_t);
+	void sendCodeFrame(const UNITCONFIG *);
+	void countAirtime(uint16_t, uint16_t);
+	void unitStateSet(uint8_t, uint8_t, uint8_t);
+	const UNITCONFIG *config;
+
+	PROFILE_ENTER(PROFILE_SENDSIGNAL);
+
+	config = unitConfigFind(major, minor);
+
+	encodeCodeWord(major, minor, command);
+
+	sendCodeFrame(config);
+
+	countAirtime(config->turnOn + config->repeats * WORDAIRTIME, FRAMEAIRTIME);
+
+	unitStateSet(major, minor, command);
+
+	PROFILE_EXIT(PROFILE_SENDSIGNAL);
+
+	return config->turnOn + config->repeats * WORDAIRTIME + config->gap;
+}
+
+
+/*	Add a signal to the transmit queue
+ *
+ *	The signal is sent later by rfTask(), which spreads the transmissions
+ *	over multiple passes of the main loop.
+ *
+ *	late	for a scheduled action the seconds since it was due (max 254), else RFNOTDUE
+ *			(also used by queueAction() for an action too late to report);
+ *			rfTask() adds the time spent in the queue and counts the total in the
+ *			lateness histogram
+ *
+ *	Return: OK, or ERROR if the queue is full
+ *
+ */
+int rfEnqueue(uint8_t major, uint8_t minor, uint8_t command, uint8_t late)
+{
+	uint16_t timer1Millis(void);
+	uint8_t i;
+
+	if (queueCount == RFQUEUESIZE)
+		return ERROR;
+
+	i = (queueHead + queueCount) % RFQUEUESIZE;
+
+	queue[i].major = major;
+	queue[i].minor = minor;
+	queue[i].command = command;
+	queue[i].late = late;
+	queue[i].queued = timer1Millis();
+
+	queueCount++;
+
+	if (queueCount > statistics.rfQueueMax)
+		statistics.rfQueueMax = queueCount;
+
+	eventPost(EVENT_RF);
+
+	return OK;
+}
+
+
+/*	Add a scene to the transmit queue
+ *
+ *	All units of the scene are queued at once, and rfTask() sends them in a
+ *	single transmitter burst as far as its airtime budget allows.
+ *
+ *	count	number of units in the scene (1 to SCENESIZE)
+ *	unit	count x 3 bytes: major unit id, minor unit id, command
+ *
+ *	Return: OK, or ERROR if the queue has no room for the whole scene
+ *
+ */
+int rfEnqueueScene(uint8_t count, uint8_t *unit)
+{
+	if (RFQUEUESIZE - queueCount < count)
+		return ERROR;
+
+	for (; count > 0; count--, unit += 3)			// all but the last signal are sent together with the next one
+		rfEnqueue(unit[0], unit[1], unit[2] | (count > 1 ? RFBURST : 0), RFNOTDUE);
+
+	return OK;
+}
+
+
+/*	Return the number of signals waiting in the transmit queue
+ *
+ */
+uint8_t rfPending(void)
+{
+	return queueCount;
+}
+
+
+/*	Transmit signals from the queue until the airtime budget is spent
+ *
+ *	At least one signal is sent (if any is waiting) as a code frame can not be
+ *	interrupted. Once the budget is used up control returns to the caller, so
+ *	the main loop can service the serial port before the next frame is sent.
+ *
+ *	The signals of a scene (see rfEnqueueScene()) are sent in a single burst.
+ *	If the budget does not allow the whole scene, the rest of it is sent in
+ *	the next burst.
+ *
+ *	budget	airtime in milliseconds
+ *
+ */
+void rfTask(uint16_t budget)
+{
+	const UNITCONFIG *unitConfigFind(uint8_t, uint8_t);
+	uint16_t timer1Millis(void);
+	void countLateness(uint32_t);
+	const UNITCONFIG *config;
+	SIGNAL *signal;
+	uint16_t airtime = 0, frames, turnOn;
+	uint8_t n, unit[SCENESIZE * 3];
+
+	while (queueCount > 0) {
+		signal = &queue[queueHead];
+		config = unitConfigFind(signal->major, signal->minor);
+
+		if (airtime > 0 && airtime + config->turnOn + config->repeats * WORDAIRTIME + config->gap > budget)
+			break;
+
+		if (signal->command & RFBURST) {			// collect the signals of the scene which fit in the budget
+			n = 0;
+			turnOn = frames = 0;
+			do {
+				signal = &queue[(queueHead + n) % RFQUEUESIZE];
+				config = unitConfigFind(signal->major, signal->minor);
+				if (n > 0 && airtime + (config->turnOn > turnOn ? config->turnOn : turnOn)
+						+ frames + config->repeats * WORDAIRTIME + config->gap > budget)
+					break;
+				if (config->turnOn > turnOn)
+					turnOn = config->turnOn;
+				frames += config->repeats * WORDAIRTIME + config->gap;
+				unit[n * 3] = signal->major;
+				unit[n * 3 + 1] = signal->minor;
+				unit[n * 3 + 2] = signal->command & ~RFBURST;
+				n++;
+			} while ((signal->command & RFBURST) && n < queueCount);	// up to the last signal of the scene
+
+			airtime += sendScene(n, unit);
+
+			queueHead = (queueHead + n) % RFQUEUESIZE;
+			queueCount -= n;
+			continue;
+		}
+
+		if (signal->late != RFNOTDUE)				// lateness at the moment the transmitter is switched on
+			countLateness(signal->late * 1000UL + (uint16_t)(timer1Millis() - signal->queued));
+
+		airtime += sendSignal(signal->major, signal->minor, signal->command);
+
+		queueHead = (queueHead + 1) % RFQUEUESIZE;
+		queueCount--;
+	}
+
+	if (queueCount > 0)								// come back once the more important tasks have run
+		eventPost(EVENT_RF);
+}
+
+
+/*	Send a scene to a number of units
+ *
+ *	The transmitter is switched on only once, and the code frames for
+ *	all units are sent back to back in this single power-on window.
+ *
+ *	count	number of units in the scene
+ *	unit	count x 3 bytes: major unit id, minor unit id, command
+ *
+ *	Return: time in ms the transmission took
+ *
+ */
+uint16_t sendScene(uint8_t count, uint8_t *unit)
+{
+	const UNITCONFIG *unitConfigFind(uint8_t, uint8_t);
+	void encodeCodeWord(uint8_t, uint8_t, uint8_t);
+	void sendCodeWord();
+	void countAirtime(uint16_t, uint16_t);
+	void unitStateSet(uint8_t, uint8_t, uint8_t);
+	void delay(uint8_t);
+	const UNITCONFIG *config;
+	uint8_t i, turnOn = 0;
+	uint16_t airtime;
+
+	for (i = 0; i < count * 3; i += 3) {			// the longest turn-on delay of all units applies
+		config = unitConfigFind(unit[i], unit[i+1]);
+		if (config->turnOn > turnOn)
+			turnOn = config->turnOn;
+	}
+
+	bitSet(RFPORT,(1<<XMBIT));						// switch transmitter on
+	delay(turnOn); 									// turn-on delay
+
+	countAirtime(turnOn, 0);
+	airtime = turnOn;
+
+	for (; count > 0; count--, unit += 3) {
+		config = unitConfigFind(unit[0], unit[1]);
+
+		encodeCodeWord(unit[0], unit[1], unit[2]);
+
+		for (i = 0; i < config->repeats; i++)		// repeat code word multiple times
+			sendCodeWord();
+
+		delay(config->gap);
+
+		countAirtime(config->repeats * WORDAIRTIME, FRAMEAIRTIME);
+		airtime += config->repeats * WORDAIRTIME + config->gap;
+
+		unitStateSet(unit[0], unit[1], unit[2]);
+	}
+
+	bitClr(RFPORT, (1<<XMBIT));						// switch transmitter off
+
+	return airtime;
+}
+
+
+/*	Remember the last command sent to a unit
+ *
+ *	Only unitState[] in RAM is updated, the byte is marked for unitStateSave().
+ *
+ */
+void unitStateSet(uint8_t major, uint8_t minor, uint8_t command)
+{
+	uint8_t	unit, byte, mask;
+
+	unit = ((major - 'A') << 4) | ((minor - 1) & 0x0F);
+	byte = unit >> 3;
+	mask = 1 << (unit & 0x07);
+
+	if (((unitState[byte] & mask) != 0) != (command != 0)) {
+		unitState[byte] ^= mask;
+		unitStateDirty |= (uint32_t)1 << byte;
+	}
+
+#if UNITREFRESH
+	unitKnown[byte] |= mask;
+#endif
+}
+
+
+/*	Load the unit states from DS1307 RAM
+ *
+ *	If the DS1307 RAM was never initialized (or its battery ran down) all
+ *	units are assumed to be off.
+ *
+ */
+void unitStateLoad(void)
+{
+	uint8_t	i, magic;
+
+	if (DS1307ReadData(UNITSTATEADDRESS + UNITSTATESIZE, 1, &magic) == 1 && magic == UNITSTATEMAGIC)
+		if (DS1307ReadData(UNITSTATEADDRESS, UNITSTATESIZE, unitState) == UNITSTATESIZE)
+			return;
+
+	for (i = 0; i < UNITSTATESIZE; i++)
+		unitState[i] = 0;
+
+	unitStateDirty = 0xFFFFFFFF;
+	unitStateSave();
+
+	magic = UNITSTATEMAGIC;
+	DS1307WriteData(UNITSTATEADDRESS + UNITSTATESIZE, 1, &magic);
+}
+
+
+/*	Write the changed unit states to DS1307 RAM
+ *
+ *	The bytes from the first to the last changed one are written in a single
+ *	I2C transfer. Do not call while a sequential read (like openActions()) is
+ *	in progress, as the I2C bus is then still in use.
+ *
+ */
+void unitStateSave(void)
+{
+	uint8_t	first, last;
+
+	if (unitStateDirty == 0)
+		return;
+
+	for (first = 0; (unitStateDirty & ((uint32_t)1 << first)) == 0; first++)
+		;
+	for (last = UNITSTATESIZE - 1; (unitStateDirty & ((uint32_t)1 << last)) == 0; last--)
+		;
+
+	if (DS1307WriteData(UNITSTATEADDRESS + first, last - first + 1, &unitState[first]) == last - first + 1)
+		unitStateDirty = 0;
+}
+
+
+/*	Re-send the last command to a unit, called every minute
+ *
+ *	Every UNITREFRESH minutes one unit which has received a command since
+ *	startup is sent the same command again, in turn. This recovers receivers
+ *	which missed a frame. The refresh waits while other signals are queued.
+ *
+ */
+void unitRefresh(void)
+{
+#if UNITREFRESH
+	static uint8_t minutes, unit;
+	uint16_t i;
+
+	if (++minutes < UNITREFRESH)
+		return;
+
+	if (rfPending() > 0)
+		return;
+
+	minutes = 0;
+
+	for (i = 0; i < UNITSTATESIZE * 8; i++) {
+		unit++;												// wraps from 255 to 0
+		if (unitKnown[unit >> 3] & (1 << (unit & 0x07))) {
+			rfEnqueue('A' + (unit >> 4), (unit & 0x0F) + 1, (unitState[unit >> 3] >> (unit & 0x07)) & 0x01, RFNOTDUE);
+			break;
+		}
+	}
+#endif
+}
+
+
+/*	Load the unit configuration from EEPROM into RAM
+ *
+ *	Entries with an invalid repeat count (like in erased EEPROM) are marked as not used.
+ *
+ */
+void unitConfigLoad(void)
+{
+	uint8_t i;
+
+	eeprom_read_block(unitConfig, unitConfigEeprom, sizeof(unitConfig));
+
+	for (i = 0; i < UNITCONFIGSIZE; i++)
+		if (unitConfig[i].repeats > MAXREPEATS)
+			unitConfig[i].repeats = 0;
+}
+
+
+/*	Store the unit configuration from RAM in EEPROM
+ *
+ *	Only bytes which have changed are actually written.
+ *
+ *	Return: OK, or ERROR if an entry contains an invalid repeat count (nothing is written)
+ *
+ */
+int unitConfigSave(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < UNITCONFIGSIZE; i++)
+		if (unitConfig[i].repeats > MAXREPEATS) {
+			unitConfigLoad();
+			return ERROR;
+		}
+
+	eeprom_update_block(unitConfig, unitConfigEeprom, sizeof(unitConfig));
+
+	return OK;
+}
+
+
+/*	Find the configuration of a unit
+ *
+ *	Return: pointer to the unit's entry in the table, or to the default configuration
+ *
+ */
+const UNITCONFIG *unitConfigFind(uint8_t major, uint8_t minor)
+{
+	uint8_t	i, unit;
+
+	unit = ((major - 'A') << 4) | ((minor - 1) & 0x0F);
+
+	for (i = 0; i < UNITCONFIGSIZE; i++)
+		if (unitConfig[i].repeats != 0 && unitConfig[i].unit == unit)
+			return &unitConfig[i];
+
+	return &unitDefault;
+}
+
+
+/*	Update the airtime counters
+ *
+ *	airtime		transmitter on-time in ms
+ *	standard	on-time in ms the same transmission would take using the default configuration
+ *
+ */
+void countAirtime(uint16_t airtime, uint16_t standard)
+{
+	if (standard)
+		statistics.rfFrames++;
+	statistics.rfAirtime += airtime;
+	statistics.rfAirtimeSaved += (int16_t)(standard - airtime);
+}
+
+
+/*	Add the lateness of a scheduled action to the histogram
+ *
+ *	ms	milliseconds between the time the action was due and its transmission
+ *
+ */
+void countLateness(uint32_t ms)
+{
+	uint8_t	bucket;
+
+	if (ms > lateness.max)
+		lateness.max = ms;
+
+	ms /= LATENESSWIDTH * 1000UL;
+	bucket = ms < LATENESSBUCKETS ? ms : LATENESSBUCKETS - 1;
+
+	if (lateness.count[bucket] < 0xFFFF)
+		lateness.count[bucket]++;
+}
+
+
+/*	Wait a number of milliseconds
+ *
+ *	_delay_ms() only accepts compile time constants, so loop over 1 ms delays.
+ *
+ */
+void delay(uint8_t ms)
+{
+	while (ms--)
+		_delay_ms(1);
+}
+
+
+/*	Translate unit id's and command into the bits of a code word
+ *
+ *	Code bits are stored in array bit[]
+ *
+ */
+void encodeCodeWord(uint8_t major, uint8_t minor, uint8_t command)
+{
+	uint8_t	i;
+
+	major -= 'A';									// major unit id numbers starts at 0
+	minor -= 1;										// minor unit id numbers starts at 0
+
+	for (i = 0; i < 4; i++) {
+		bit[i] = (major & 0x01) ? FLOAT : LOW;		// bits 0-3 contain major unit id (2^4 = 16 major units)
+		major = major >> 1;
+	}
+
+	for (i = 4; i < 8; i++) {
+		bit[i] = (minor & 0x01) ? FLOAT : LOW;		// bits 4-7 contain minor unit id (2^4 = 16 minor units)
+		minor = minor >> 1;
+    }
+
+	bit[8] = LOW;									// bits 8-10 contain fixed values
+	bit[9] = FLOAT;
+	bit[10]= FLOAT;
+	bit[11]= (command ? FLOAT : LOW);				// bit 11 contains the command = switch unit on or off
+}
+
+
+/*	Send code frame
+ *
+ *	Frame consists of a code word repeated X times
+ *
+ *	config	unit configuration with repeat count and guard times
+ *
+ */
+void sendCodeFrame(const UNITCONFIG *config)
+{
+	void sendCodeWord();
+	void delay(uint8_t);
+	uint8_t i;
+
+	bitSet(RFPORT,(1<<XMBIT));						// switch transmitter on
+	delay(config->turnOn); 							// turn-on delay
+
+	for (i = 0; i < config->repeats; i++)			// repeat code word multiple times
+		sendCodeWord();
+
+	bitClr(RFPORT, (1<<XMBIT));						// switch transmitter off
+
+	delay(config->gap);								// guard time before the next frame
+}
+
+
+/*	Send a 12-bit code word plus single sync bit
+ *
+ *	Code bits are stored in array bit[]
+ *
+ */
+void sendCodeWord()
+{
+	void sendCodeBit(input_t);
+	void sendSyncBit();
+	uint8_t	i;
+
+	for (i = 0; i < 12; i++)						// code word contains 12 bits
+		sendCodeBit(bit[i]);
+
+	sendSyncBit();
+}
+
+
+/*	Transmit a single code bit
+ *
+ *	Format (one period per bit):
+ *
+ *	Low		1 0 0 0 1 0 0 0
+ *	High	1 1 1 0 1 1 1 0
+ *	Float	1 0 0 0 1 1 1 0
+ */
+void sendCodeBit(input_t bit)
+{
+	switch (bit) {
+		case LOW:
+			bitSet(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS);
+			bitClr(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS * 3);
+			bitSet(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS);
+			bitClr(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS * 3);
+			break;
+		case HIGH:
+			bitSet(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS * 3);
+			bitClr(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS);
+			bitSet(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS * 3);
+			bitClr(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS);
+			break;
+		case FLOAT:
+			bitSet(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS);
+			bitClr(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS * 3);
+			bitSet(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS * 3);
+			bitClr(RFPORT, (1<<RFBIT));
+			_delay_us(DELAY_MICROSECONDS);
+			break;
+	}
+}
+
+
+/*	Transmit synchronization signal
+ *
+ *	Format (one period per bit)
+ *
+ *	1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0
+ *
+ * 	(equals 1 x H and 31 x 0)
+ */
+void sendSyncBit()
+{
+	bitSet(RFPORT, (1<<RFBIT));
+	_delay_us(DELAY_MICROSECONDS);
+	bitClr(RFPORT, (1<<RFBIT));
+	_delay_us(DELAY_MICROSECONDS * 31);
+}
@@ -1,12 +1,70 @@
-/*	remote.h
- *
- *	Defines for controlling remote switches
- *
- *	2009	K.W.E. de Lange
- */
-#ifndef _REMOTE_
-#define _REMOTE_
-
-void sendSignal(uint8_t major, uint8_t minor, uint8_t command);
-
-#endif /* _REMOTE_ */
+/*	remote.h
+ *
+ *	Defines for controlling remote switches
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _REMOTE_
+#define _REMOTE_
+
+#define DELAY_MICROSECONDS	375		// Time length of a single code bit (in micro-seconds)
+#define	REPEATS				4		// Default number of times code word is repeated within a code frame
+#define MAXREPEATS			16		// Maximum number of times a code word can be repeated
+#define TURNONDELAY			2		// Default delay (ms) between switching on the transmitter and sending
+
+/*	Airtime of a code word in milliseconds. A code word is 12 code bits of 8 periods
+ *	plus a sync bit of 32 periods. A default code frame is the turn-on delay plus
+ *	the repeated code words.
+ *
+ */
+#define WORDAIRTIME			((12 * 8 + 32) * (uint32_t)DELAY_MICROSECONDS / 1000)
+#define FRAMEAIRTIME		(TURNONDELAY + REPEATS * WORDAIRTIME)
+
+#define SCENESIZE			16		// Maximum number of units in a scene
+#define RFQUEUESIZE			16		// Maximum number of signals waiting to be transmitted
+
+#define UNITCONFIGSIZE		16		// Maximum number of units with a non-default configuration
+
+#define UNITSTATESIZE		32		// Bytes in the unit state bitmap: 16 major x 16 minor units, one bit each
+#define UNITSTATEADDRESS	0x10	// Location of the unit state bitmap in DS1307 RAM
+#define UNITSTATEMAGIC		0x5A	// Stored behind the bitmap in DS1307 RAM once it has been initialized
+
+#ifndef UNITREFRESH
+#define UNITREFRESH			0		// Minutes between re-sending the last command to a unit, 0 = no refresh
+#endif
+
+#define RFNOTDUE			0xFF	// Lateness of a signal which is not a scheduled action, see rfEnqueue()
+#define RFBURST				0x80	// Set in the command of a queued signal which is sent in one burst with the next one
+
+#if SCENESIZE > RFQUEUESIZE
+#error a scene must fit in the transmit queue
+#endif
+
+#ifndef RFBUDGET
+#define RFBUDGET			200		// Airtime (ms) which may be spent on transmitting per run of the transmit task
+#endif
+
+typedef struct						// unit configuration record layout
+{
+	uint8_t	unit;					// major unit id - 'A' in the high nibble, minor unit id - 1 in the low nibble
+	uint8_t	repeats;				// number of code words in a code frame (1 to MAXREPEATS), 0 if entry is not used
+	uint8_t	turnOn;					// delay in ms between switching on the transmitter and sending the first code word
+	uint8_t	gap;					// idle time in ms after the code frame
+} UNITCONFIG;
+
+extern UNITCONFIG unitConfig[UNITCONFIGSIZE];
+extern uint8_t unitState[UNITSTATESIZE];
+
+uint16_t sendSignal(uint8_t major, uint8_t minor, uint8_t command);
+uint16_t sendScene(uint8_t count, uint8_t *unit);
+int rfEnqueue(uint8_t major, uint8_t minor, uint8_t command, uint8_t late);
+int rfEnqueueScene(uint8_t count, uint8_t *unit);
+uint8_t rfPending(void);
+void rfTask(uint16_t budget);
+void unitConfigLoad(void);
+int unitConfigSave(void);
+void unitStateLoad(void);
+void unitStateSave(void);
+void unitRefresh(void);
+
+#endif /* _REMOTE_ */
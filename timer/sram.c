@@ -0,0 +1,48 @@
+/*	sram.c
+ *
+ *	Measure the SRAM usage.
+ *
+ *	Before main() is started all SRAM between the static variables and the
+ *	top of the stack is filled with SRAMCANARY. The stack grows down into this
+ *	area, so the lowest address where the pattern has been overwritten shows
+ *	the deepest the stack has ever been. The heap is not used (no malloc).
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include <avr/io.h>
+#include "sram.h"
+
+extern uint8_t __heap_start;			// first byte after .data, .bss and .noinit (set by the linker)
+extern uint8_t __stack;					// top of the stack, RAMEND
+
+
+/*	Paint the free SRAM, in .init3 like wdt_init().
+ *
+ *	The stack pointer has just been set and nothing has been pushed yet, so the
+ *	complete area up to RAMEND can be painted. As the function is naked it may
+ *	not use the stack itself; the pointer is kept in registers.
+ *
+ */
+void sramPaint(void) __attribute__((naked)) __attribute__((section(".init3")));
+
+void sramPaint(void)
+{
+	uint8_t *p;
+
+	for (p = &__heap_start; p <= &__stack; p++)
+		*p = SRAMCANARY;
+}
+
+
+void sramUsage(SRAMUSAGE *usage)
+{
+	const uint8_t *p = &__heap_start;
+
+	while (p <= &__stack && *p == SRAMCANARY)		// find the lowest byte the stack has touched
+		p++;
+
+	usage->staticSize = &__heap_start - (uint8_t *)RAMSTART;
+	usage->stackMax = &__stack + 1 - p;
+	usage->freeNow = (uint8_t *)SP - &__heap_start;
+	usage->freeMin = p - &__heap_start;
+}
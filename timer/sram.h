@@ -0,0 +1,24 @@
+/*	sram.h
+ *
+ *	Defines for measuring the SRAM usage
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _SRAM_
+#define _SRAM_
+
+#include <stdint.h>
+
+#define SRAMCANARY		0xC5			// pattern written to the free SRAM at startup
+
+typedef struct							// SRAM usage record layout, all values in bytes
+{
+	uint16_t staticSize;				// .data, .bss and .noinit together
+	uint16_t stackMax;					// deepest stack usage since startup
+	uint16_t freeNow;					// space between the static variables and the current stack pointer
+	uint16_t freeMin;					// SRAM which has never been touched since startup
+} SRAMUSAGE;
+
+void sramUsage(SRAMUSAGE *usage);
+
+#endif /* _SRAM_ */
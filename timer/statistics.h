@@ -0,0 +1,43 @@
+/*	statistics.h
+ *
+ *	Performance counters which can be read by the client
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _STATISTICS_
+#define _STATISTICS_
+
+#include <stdint.h>
+
+typedef struct							// statistics record layout
+{
+	uint16_t loopLatencyMax;			// worst-case duration of a task of the main loop in milliseconds
+	uint8_t	rfQueueMax;					// maximum number of signals waiting for transmission
+	uint16_t rfFrames;					// number of code frames transmitted
+	uint32_t rfAirtime;					// total transmitter airtime in milliseconds
+	int32_t	rfAirtimeSaved;				// airtime saved by the unit configuration compared to the default code frame
+	uint16_t rxOverflows;				// number of bytes lost because the receive buffer was full
+	uint16_t cacheHits;					// number of EEPROM cache lines found in RAM
+	uint16_t cacheMisses;				// number of EEPROM cache lines read from the EEPROM
+	uint16_t actionErrors;				// number of times an action record with a wrong CRC was read
+	uint16_t actionErrorLast;			// index of the last action record found with a wrong CRC
+	uint16_t scrubPasses;				// number of complete checks of the active schedule by the scrub task
+	uint16_t scrubTimeMax;				// worst-case duration of a run of the scrub task in milliseconds
+} STATISTICS;
+
+extern STATISTICS statistics;
+
+#ifndef LATENESSBUCKETS
+#define LATENESSBUCKETS		16			// number of buckets of the lateness histogram, the last one also counts all later actions
+#endif
+#define LATENESSWIDTH		10			// width of a lateness histogram bucket in seconds
+
+typedef struct							// lateness histogram record layout
+{
+	uint32_t max;						// largest lateness in milliseconds
+	uint16_t count[LATENESSBUCKETS];	// number of actions per LATENESSWIDTH seconds of lateness, stops counting at 65535
+} LATENESS;
+
+extern LATENESS lateness;
+
+#endif /* _STATISTICS_ */
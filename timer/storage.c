@@ -0,0 +1,74 @@
+/*	storage.c
+ *
+ *	Storage backends for the action table.
+ *
+ *	The AVR internal EEPROM is small but needs no I2C transactions. It holds
+ *	the data which is read at boot or every minute (the schedule header and
+ *	the unit configuration) and, on a board without an I2C EEPROM, also the
+ *	action table. Otherwise the action table is stored in the I2C EEPROM(s).
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include <avr/eeprom.h>
+#include "define.h"
+#include "storage.h"
+#include "24cXX.h"
+#include "cache.h"
+
+
+static uint8_t avrStorageEeprom[AVRSTORAGESIZE] EEMEM;
+static uint16_t avrReadAddr;			// address of the next byte of a sequential read
+
+
+static int avrReadData(uint32_t addr, int len, uint8_t *d)
+{
+	if (addr + len > AVRSTORAGESIZE)
+		return -1;
+
+	eeprom_read_block(d, &avrStorageEeprom[addr], len);
+
+	return len;
+}
+
+
+static int avrWriteData(uint32_t addr, int len, uint8_t *d)
+{
+	if (addr + len > AVRSTORAGESIZE)
+		return -1;
+
+	eeprom_update_block(d, &avrStorageEeprom[addr], len);	// only bytes which have changed are actually written
+
+	return len;
+}
+
+
+static int avrReadOpen(uint32_t addr)
+{
+	if (addr >= AVRSTORAGESIZE)
+		return -1;
+
+	avrReadAddr = addr;
+
+	return 0;
+}
+
+
+static int avrReadNext(int len, uint8_t *d)
+{
+	if (avrReadData(avrReadAddr, len, d) != len)
+		return -1;
+
+	avrReadAddr += len;
+
+	return len;
+}
+
+
+static void avrReadClose(void)
+{
+}
+
+
+const STORAGE avrStorage = { avrReadData, avrWriteData, avrReadOpen, avrReadNext, avrReadClose };
+
+const STORAGE i2cStorage = { cacheReadData, cacheWriteData, ee24CXXReadOpen, ee24CXXReadNext, ee24CXXReadClose };
@@ -0,0 +1,34 @@
+/*	storage.h
+ *
+ *	Interface to the memory holding the action table
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _STORAGE_
+#define _STORAGE_
+
+#include <stdint.h>
+
+#ifndef AVRSTORAGESIZE
+#define AVRSTORAGESIZE	320				// bytes of the AVR internal EEPROM used for actions when there is no I2C EEPROM
+#endif
+
+/*	A storage backend. All functions follow the conventions of the ee24CXX routines:
+ *	addresses are linear from 0, read and write return the number of bytes transferred
+ *	or -1 in case of error. A sequential read is started with readOpen, continued
+ *	with readNext and ended with readClose. A failed readNext closes the read.
+ *
+ */
+typedef struct
+{
+	int		(*readData)(uint32_t addr, int len, uint8_t *d);
+	int		(*writeData)(uint32_t addr, int len, uint8_t *d);
+	int		(*readOpen)(uint32_t addr);
+	int		(*readNext)(int len, uint8_t *d);
+	void	(*readClose)(void);
+} STORAGE;
+
+extern const STORAGE avrStorage;		// AVR internal EEPROM, no bus transactions needed
+extern const STORAGE i2cStorage;		// one or more 24cXX I2C EEPROMs, random reads via the RAM cache
+
+#endif /* _STORAGE_ */
@@ -0,0 +1,56 @@
+/*	sun.c
+ *
+ *	Sunrise and sunset times.
+ *
+ *	The times are not calculated on the AVR but looked up in a table in flash
+ *	memory with an entry for every day of the year. The table is generated on
+ *	the PC for the location of the timer by client/suntable.py (see suntable.c).
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include "define.h"
+#include "utility.h"
+#include "sun.h"
+
+
+/*	Check if European summer time applies on the date in dt.
+ *
+ *	Summer time runs from the last Sunday of March to the last Sunday of October.
+ *	Both months have 31 days, so their last Sunday falls on the 25th or later. The
+ *	clock changes early in the morning, before sunrise, so a switch-over day counts
+ *	as the new time the whole day: summer time in March, standard time in October.
+ *
+ */
+static boolean summerTime(datetime *dt)
+{
+	int sunday = dt->dd - (dt->day % 7);					// date of the most recent Sunday (ISO weekday: Sunday = 7)
+
+	if (dt->mm > 3 && dt->mm < 10)
+		return TRUE;
+	if (dt->mm == 3)
+		return sunday >= 25 ? TRUE : FALSE;
+	if (dt->mm == 10)
+		return sunday >= 25 ? FALSE : TRUE;
+	return FALSE;
+}
+
+
+/*	Return the time of sunrise or sunset on the date in dt.
+ *
+ *	event	SUNRISE or SUNSET
+ *
+ *	Return: minutes since 00:00 in the time of the DS1307
+ *
+ */
+int sunTime(uint8_t event, datetime *dt)
+{
+	const SUNTIMES *entry = &sunTable[dayOfYear(dt->dd, dt->mm, TRUE)];
+	int time;
+
+	time = pgm_read_word(event == SUNRISE ? &entry->rise : &entry->set);
+
+	if (SUNDST && summerTime(dt) == TRUE)
+		time += 60;
+
+	return time;
+}
@@ -0,0 +1,33 @@
+/*	sun.h
+ *
+ *	Defines for sunrise and sunset times
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _SUN_
+#define _SUN_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "ds1307.h"
+
+#ifndef SUNDST
+#define SUNDST			1				// 1 if the DS1307 follows European summer time, 0 if it always runs in standard time
+#endif
+
+#define SUNRISE			0
+#define SUNSET			1
+
+#define SUNTABLESIZE	366				// one entry per day of a leap year
+
+typedef struct							// sun table entry layout
+{
+	uint16_t rise;						// sunrise in minutes since 00:00 local standard time
+	uint16_t set;						// sunset in minutes since 00:00 local standard time
+} SUNTIMES;
+
+extern const SUNTIMES sunTable[SUNTABLESIZE] PROGMEM;
+
+int sunTime(uint8_t event, datetime *dt);
+
+#endif /* _SUN_ */
@@ -0,0 +1,378 @@
+/*	suntable.c
+ *
+ *	Sunrise and sunset per day of the year, in minutes since 00:00 local standard time.
+ *
+ *	Generated by client/suntable.py for latitude 52.09, longitude 5.12, UTC+1 - do not edit.
+ *
+ */
+#include <avr/pgmspace.h>
+#include "sun.h"
+
+const SUNTIMES sunTable[SUNTABLESIZE] PROGMEM = {
+	{  528,  997 },		// 01-01
+	{  528,  998 },		// 02-01
+	{  528,  999 },		// 03-01
+	{  527, 1000 },		// 04-01
+	{  527, 1001 },		// 05-01
+	{  527, 1002 },		// 06-01
+	{  526, 1004 },		// 07-01
+	{  526, 1005 },		// 08-01
+	{  526, 1006 },		// 09-01
+	{  525, 1008 },		// 10-01
+	{  524, 1009 },		// 11-01
+	{  524, 1010 },		// 12-01
+	{  523, 1012 },		// 13-01
+	{  522, 1013 },		// 14-01
+	{  521, 1015 },		// 15-01
+	{  521, 1016 },		// 16-01
+	{  520, 1018 },		// 17-01
+	{  519, 1020 },		// 18-01
+	{  518, 1021 },		// 19-01
+	{  517, 1023 },		// 20-01
+	{  516, 1025 },		// 21-01
+	{  515, 1026 },		// 22-01
+	{  513, 1028 },		// 23-01
+	{  512, 1030 },		// 24-01
+	{  511, 1032 },		// 25-01
+	{  510, 1033 },		// 26-01
+	{  508, 1035 },		// 27-01
+	{  507, 1037 },		// 28-01
+	{  505, 1039 },		// 29-01
+	{  504, 1041 },		// 30-01
+	{  503, 1042 },		// 31-01
+	{  501, 1044 },		// 01-02
+	{  499, 1046 },		// 02-02
+	{  498, 1048 },		// 03-02
+	{  496, 1050 },		// 04-02
+	{  495, 1052 },		// 05-02
+	{  493, 1054 },		// 06-02
+	{  491, 1056 },		// 07-02
+	{  490, 1058 },		// 08-02
+	{  488, 1059 },		// 09-02
+	{  486, 1061 },		// 10-02
+	{  484, 1063 },		// 11-02
+	{  482, 1065 },		// 12-02
+	{  480, 1067 },		// 13-02
+	{  479, 1069 },		// 14-02
+	{  477, 1071 },		// 15-02
+	{  475, 1073 },		// 16-02
+	{  473, 1075 },		// 17-02
+	{  471, 1077 },		// 18-02
+	{  469, 1078 },		// 19-02
+	{  467, 1080 },		// 20-02
+	{  465, 1082 },		// 21-02
+	{  463, 1084 },		// 22-02
+	{  461, 1086 },		// 23-02
+	{  459, 1088 },		// 24-02
+	{  456, 1090 },		// 25-02
+	{  454, 1092 },		// 26-02
+	{  452, 1093 },		// 27-02
+	{  450, 1095 },		// 28-02
+	{  448, 1097 },		// 29-02
+	{  446, 1099 },		// 01-03
+	{  443, 1101 },		// 02-03
+	{  441, 1102 },		// 03-03
+	{  439, 1104 },		// 04-03
+	{  437, 1106 },		// 05-03
+	{  435, 1108 },		// 06-03
+	{  432, 1110 },		// 07-03
+	{  430, 1111 },		// 08-03
+	{  428, 1113 },		// 09-03
+	{  425, 1115 },		// 10-03
+	{  423, 1117 },		// 11-03
+	{  421, 1119 },		// 12-03
+	{  419, 1120 },		// 13-03
+	{  416, 1122 },		// 14-03
+	{  414, 1124 },		// 15-03
+	{  412, 1126 },		// 16-03
+	{  409, 1127 },		// 17-03
+	{  407, 1129 },		// 18-03
+	{  405, 1131 },		// 19-03
+	{  402, 1132 },		// 20-03
+	{  400, 1134 },		// 21-03
+	{  398, 1136 },		// 22-03
+	{  395, 1138 },		// 23-03
+	{  393, 1139 },		// 24-03
+	{  391, 1141 },		// 25-03
+	{  388, 1143 },		// 26-03
+	{  386, 1144 },		// 27-03
+	{  384, 1146 },		// 28-03
+	{  381, 1148 },		// 29-03
+	{  379, 1150 },		// 30-03
+	{  377, 1151 },		// 31-03
+	{  374, 1153 },		// 01-04
+	{  372, 1155 },		// 02-04
+	{  370, 1156 },		// 03-04
+	{  367, 1158 },		// 04-04
+	{  365, 1160 },		// 05-04
+	{  363, 1161 },		// 06-04
+	{  360, 1163 },		// 07-04
+	{  358, 1165 },		// 08-04
+	{  356, 1166 },		// 09-04
+	{  354, 1168 },		// 10-04
+	{  351, 1170 },		// 11-04
+	{  349, 1172 },		// 12-04
+	{  347, 1173 },		// 13-04
+	{  345, 1175 },		// 14-04
+	{  342, 1177 },		// 15-04
+	{  340, 1178 },		// 16-04
+	{  338, 1180 },		// 17-04
+	{  336, 1182 },		// 18-04
+	{  334, 1183 },		// 19-04
+	{  331, 1185 },		// 20-04
+	{  329, 1187 },		// 21-04
+	{  327, 1188 },		// 22-04
+	{  325, 1190 },		// 23-04
+	{  323, 1192 },		// 24-04
+	{  321, 1194 },		// 25-04
+	{  319, 1195 },		// 26-04
+	{  317, 1197 },		// 27-04
+	{  315, 1199 },		// 28-04
+	{  313, 1200 },		// 29-04
+	{  311, 1202 },		// 30-04
+	{  309, 1204 },		// 01-05
+	{  307, 1205 },		// 02-05
+	{  305, 1207 },		// 03-05
+	{  303, 1209 },		// 04-05
+	{  302, 1210 },		// 05-05
+	{  300, 1212 },		// 06-05
+	{  298, 1214 },		// 07-05
+	{  296, 1215 },		// 08-05
+	{  294, 1217 },		// 09-05
+	{  293, 1219 },		// 10-05
+	{  291, 1220 },		// 11-05
+	{  289, 1222 },		// 12-05
+	{  288, 1223 },		// 13-05
+	{  286, 1225 },		// 14-05
+	{  285, 1226 },		// 15-05
+	{  283, 1228 },		// 16-05
+	{  282, 1229 },		// 17-05
+	{  280, 1231 },		// 18-05
+	{  279, 1232 },		// 19-05
+	{  278, 1234 },		// 20-05
+	{  276, 1235 },		// 21-05
+	{  275, 1237 },		// 22-05
+	{  274, 1238 },		// 23-05
+	{  273, 1240 },		// 24-05
+	{  271, 1241 },		// 25-05
+	{  270, 1242 },		// 26-05
+	{  269, 1244 },		// 27-05
+	{  268, 1245 },		// 28-05
+	{  267, 1246 },		// 29-05
+	{  266, 1247 },		// 30-05
+	{  265, 1249 },		// 31-05
+	{  265, 1250 },		// 01-06
+	{  264, 1251 },		// 02-06
+	{  263, 1252 },		// 03-06
+	{  262, 1253 },		// 04-06
+	{  262, 1254 },		// 05-06
+	{  261, 1255 },		// 06-06
+	{  261, 1256 },		// 07-06
+	{  260, 1257 },		// 08-06
+	{  260, 1257 },		// 09-06
+	{  259, 1258 },		// 10-06
+	{  259, 1259 },		// 11-06
+	{  259, 1260 },		// 12-06
+	{  258, 1260 },		// 13-06
+	{  258, 1261 },		// 14-06
+	{  258, 1261 },		// 15-06
+	{  258, 1262 },		// 16-06
+	{  258, 1262 },		// 17-06
+	{  258, 1263 },		// 18-06
+	{  258, 1263 },		// 19-06
+	{  258, 1263 },		// 20-06
+	{  258, 1264 },		// 21-06
+	{  259, 1264 },		// 22-06
+	{  259, 1264 },		// 23-06
+	{  259, 1264 },		// 24-06
+	{  260, 1264 },		// 25-06
+	{  260, 1264 },		// 26-06
+	{  261, 1264 },		// 27-06
+	{  261, 1264 },		// 28-06
+	{  262, 1264 },		// 29-06
+	{  262, 1264 },		// 30-06
+	{  263, 1263 },		// 01-07
+	{  264, 1263 },		// 02-07
+	{  265, 1262 },		// 03-07
+	{  265, 1262 },		// 04-07
+	{  266, 1262 },		// 05-07
+	{  267, 1261 },		// 06-07
+	{  268, 1260 },		// 07-07
+	{  269, 1260 },		// 08-07
+	{  270, 1259 },		// 09-07
+	{  271, 1258 },		// 10-07
+	{  272, 1258 },		// 11-07
+	{  273, 1257 },		// 12-07
+	{  275, 1256 },		// 13-07
+	{  276, 1255 },		// 14-07
+	{  277, 1254 },		// 15-07
+	{  278, 1253 },		// 16-07
+	{  280, 1252 },		// 17-07
+	{  281, 1251 },		// 18-07
+	{  282, 1249 },		// 19-07
+	{  284, 1248 },		// 20-07
+	{  285, 1247 },		// 21-07
+	{  286, 1246 },		// 22-07
+	{  288, 1244 },		// 23-07
+	{  289, 1243 },		// 24-07
+	{  291, 1242 },		// 25-07
+	{  292, 1240 },		// 26-07
+	{  294, 1239 },		// 27-07
+	{  295, 1237 },		// 28-07
+	{  297, 1236 },		// 29-07
+	{  298, 1234 },		// 30-07
+	{  300, 1232 },		// 31-07
+	{  301, 1231 },		// 01-08
+	{  303, 1229 },		// 02-08
+	{  304, 1227 },		// 03-08
+	{  306, 1226 },		// 04-08
+	{  307, 1224 },		// 05-08
+	{  309, 1222 },		// 06-08
+	{  311, 1220 },		// 07-08
+	{  312, 1218 },		// 08-08
+	{  314, 1217 },		// 09-08
+	{  316, 1215 },		// 10-08
+	{  317, 1213 },		// 11-08
+	{  319, 1211 },		// 12-08
+	{  320, 1209 },		// 13-08
+	{  322, 1207 },		// 14-08
+	{  324, 1205 },		// 15-08
+	{  325, 1203 },		// 16-08
+	{  327, 1201 },		// 17-08
+	{  329, 1199 },		// 18-08
+	{  330, 1196 },		// 19-08
+	{  332, 1194 },		// 20-08
+	{  333, 1192 },		// 21-08
+	{  335, 1190 },		// 22-08
+	{  337, 1188 },		// 23-08
+	{  338, 1186 },		// 24-08
+	{  340, 1184 },		// 25-08
+	{  342, 1181 },		// 26-08
+	{  343, 1179 },		// 27-08
+	{  345, 1177 },		// 28-08
+	{  346, 1175 },		// 29-08
+	{  348, 1172 },		// 30-08
+	{  350, 1170 },		// 31-08
+	{  351, 1168 },		// 01-09
+	{  353, 1166 },		// 02-09
+	{  354, 1163 },		// 03-09
+	{  356, 1161 },		// 04-09
+	{  358, 1159 },		// 05-09
+	{  359, 1156 },		// 06-09
+	{  361, 1154 },		// 07-09
+	{  363, 1152 },		// 08-09
+	{  364, 1149 },		// 09-09
+	{  366, 1147 },		// 10-09
+	{  367, 1145 },		// 11-09
+	{  369, 1142 },		// 12-09
+	{  371, 1140 },		// 13-09
+	{  372, 1138 },		// 14-09
+	{  374, 1135 },		// 15-09
+	{  375, 1133 },		// 16-09
+	{  377, 1130 },		// 17-09
+	{  379, 1128 },		// 18-09
+	{  380, 1126 },		// 19-09
+	{  382, 1123 },		// 20-09
+	{  384, 1121 },		// 21-09
+	{  385, 1119 },		// 22-09
+	{  387, 1116 },		// 23-09
+	{  388, 1114 },		// 24-09
+	{  390, 1111 },		// 25-09
+	{  392, 1109 },		// 26-09
+	{  393, 1107 },		// 27-09
+	{  395, 1104 },		// 28-09
+	{  397, 1102 },		// 29-09
+	{  398, 1100 },		// 30-09
+	{  400, 1097 },		// 01-10
+	{  402, 1095 },		// 02-10
+	{  403, 1093 },		// 03-10
+	{  405, 1090 },		// 04-10
+	{  407, 1088 },		// 05-10
+	{  408, 1086 },		// 06-10
+	{  410, 1084 },		// 07-10
+	{  412, 1081 },		// 08-10
+	{  414, 1079 },		// 09-10
+	{  415, 1077 },		// 10-10
+	{  417, 1075 },		// 11-10
+	{  419, 1072 },		// 12-10
+	{  421, 1070 },		// 13-10
+	{  422, 1068 },		// 14-10
+	{  424, 1066 },		// 15-10
+	{  426, 1064 },		// 16-10
+	{  428, 1061 },		// 17-10
+	{  429, 1059 },		// 18-10
+	{  431, 1057 },		// 19-10
+	{  433, 1055 },		// 20-10
+	{  435, 1053 },		// 21-10
+	{  437, 1051 },		// 22-10
+	{  438, 1049 },		// 23-10
+	{  440, 1047 },		// 24-10
+	{  442, 1045 },		// 25-10
+	{  444, 1043 },		// 26-10
+	{  446, 1041 },		// 27-10
+	{  448, 1039 },		// 28-10
+	{  449, 1037 },		// 29-10
+	{  451, 1035 },		// 30-10
+	{  453, 1033 },		// 31-10
+	{  455, 1031 },		// 01-11
+	{  457, 1030 },		// 02-11
+	{  459, 1028 },		// 03-11
+	{  460, 1026 },		// 04-11
+	{  462, 1024 },		// 05-11
+	{  464, 1023 },		// 06-11
+	{  466, 1021 },		// 07-11
+	{  468, 1019 },		// 08-11
+	{  470, 1018 },		// 09-11
+	{  471, 1016 },		// 10-11
+	{  473, 1015 },		// 11-11
+	{  475, 1013 },		// 12-11
+	{  477, 1012 },		// 13-11
+	{  479, 1010 },		// 14-11
+	{  480, 1009 },		// 15-11
+	{  482, 1007 },		// 16-11
+	{  484, 1006 },		// 17-11
+	{  486, 1005 },		// 18-11
+	{  487, 1003 },		// 19-11
+	{  489, 1002 },		// 20-11
+	{  491, 1001 },		// 21-11
+	{  492, 1000 },		// 22-11
+	{  494,  999 },		// 23-11
+	{  496,  998 },		// 24-11
+	{  497,  997 },		// 25-11
+	{  499,  996 },		// 26-11
+	{  500,  995 },		// 27-11
+	{  502,  994 },		// 28-11
+	{  503,  993 },		// 29-11
+	{  505,  993 },		// 30-11
+	{  506,  992 },		// 01-12
+	{  508,  991 },		// 02-12
+	{  509,  991 },		// 03-12
+	{  510,  990 },		// 04-12
+	{  512,  990 },		// 05-12
+	{  513,  989 },		// 06-12
+	{  514,  989 },		// 07-12
+	{  515,  989 },		// 08-12
+	{  516,  988 },		// 09-12
+	{  517,  988 },		// 10-12
+	{  519,  988 },		// 11-12
+	{  519,  988 },		// 12-12
+	{  520,  988 },		// 13-12
+	{  521,  988 },		// 14-12
+	{  522,  988 },		// 15-12
+	{  523,  988 },		// 16-12
+	{  524,  988 },		// 17-12
+	{  524,  989 },		// 18-12
+	{  525,  989 },		// 19-12
+	{  525,  989 },		// 20-12
+	{  526,  990 },		// 21-12
+	{  526,  990 },		// 22-12
+	{  527,  991 },		// 23-12
+	{  527,  991 },		// 24-12
+	{  527,  992 },		// 25-12
+	{  528,  993 },		// 26-12
+	{  528,  993 },		// 27-12
+	{  528,  994 },		// 28-12
+	{  528,  995 },		// 29-12
+	{  528,  996 },		// 30-12
+	{  528,  997 } 		// 31-12
+};
@@ -1,45 +1,72 @@
-/*	timer1.c
- *
- *	Routines for setting up 16-bit timer1
- *
- *	2009	K.W.E. de Lange
- */
-#include <avr/io.h>
-#include <avr/interrupt.h>
-
-#define	INITTICK	30
-
-typedef enum { FALSE = 0, TRUE} boolean;
-
-extern volatile boolean timerWakeup;
-extern volatile boolean timerEnable;
-extern volatile long disableTimeOut;
-
-
-void timer1Init(void)
-{
-	TCCR1B = (1<<WGM12)|(1<<CS12)|(1<<CS10);		// CTC mode, prescaler 1024
-	OCR1A  = 0x9895;								// compare match interrupt will occur every 2 seconds
-	TIMSK1 = (1<<OCIE1A);							// enable compare match interrupt
-
-	timerWakeup = FALSE;
-}
-
-
-/*	Timer 1 interrupt handler
- *
- *	Sets variable 'timerWakeup' to TRUE every 60 seconds
- *
- */
-ISR(TIMER1_COMPA_vect)								// timer1 interrupt is triggered every 2 seconds
-{
-	static uint8_t tick = INITTICK;
-
-	if (--tick == 0) {								// wait for 2 x 30 seconds = 60 seconds
-		tick = INITTICK;
-		timerWakeup = TRUE;							// then signal it is OK to start processing actions
-		if (timerEnable == FALSE)					// if the timer was disabled ... 
-			if (!disableTimeOut--)					// ... for more then X minutes (set to 10) then ...
-				timerEnable = TRUE;					// ... automatically enable the timer again
-	}
-}
+/*	timer1.c
+ *
+ *	Routines for setting up 16-bit timer1
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "event.h"
+
+#define	INITTICK	30
+
+typedef enum { FALSE = 0, TRUE} boolean;
+
+extern volatile boolean timerEnable;
+extern volatile long disableTimeOut;
+
+static volatile uint16_t periods;					// number of 2 second periods since startup (wraps around)
+
+
+void timer1Init(void)
+{
+	TCCR1B = (1<<WGM12)|(1<<CS12)|(1<<CS10);		// CTC mode, prescaler 1024
+	OCR1A  = 0x9895;								// compare match interrupt will occur every 2 seconds
+	TIMSK1 = (1<<OCIE1A);							// enable compare match interrupt
+}
+
+
+/*	Free running millisecond clock
+ *
+ *	Combines the number of 2 second timer periods with the current timer count.
+ *	Wraps around after 65.5 seconds, so only use to measure shorter intervals.
+ *
+ */
+uint16_t timer1Millis(void)
+{
+	uint16_t p, count;
+	uint8_t sreg;
+
+	sreg = SREG;
+	cli();
+	p = periods;
+	count = TCNT1;
+	if ((TIFR1 & (1<<OCF1A)) && count < OCR1A / 2)	// compare match occurred but interrupt is not yet handled
+		p++;
+	SREG = sreg;
+
+	return p * 2000 + (uint16_t)(((uint32_t)count * 2000) / (OCR1A + 1));
+}
+
+
+/*	Timer 1 interrupt handler
+ *
+ *	Posts EVENT_TICK and EVENT_SCRUB every 2 seconds and EVENT_MINUTE every 60 seconds
+ *
+ */
+ISR(TIMER1_COMPA_vect)								// timer1 interrupt is triggered every 2 seconds
+{
+	static uint8_t tick = INITTICK;
+
+	periods++;
+
+	eventPostISR(EVENT_TICK | EVENT_SCRUB);
+
+	if (--tick == 0) {								// wait for 2 x 30 seconds = 60 seconds
+		tick = INITTICK;
+		eventPostISR(EVENT_MINUTE);					// then signal it is OK to start processing actions
+		if (timerEnable == FALSE)					// if the timer was disabled ... 
+			if (!disableTimeOut--)					// ... for more then X minutes (set to 10) then ...
+				timerEnable = TRUE;					// ... automatically enable the timer again
+	}
+}
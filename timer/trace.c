@@ -0,0 +1,79 @@
+/*	trace.c
+ *
+ *	Binary tracing of the scheduler.
+ *
+ *	Instead of formatting text while the scheduler runs, an event id and its
+ *	raw arguments are stored in a ring buffer in RAM. The ring is drained to
+ *	the serial port from the main loop when no command is being received,
+ *	and only as far as fits in the transmit buffer, so tracing never waits
+ *	for the serial line. When the ring is full, events are dropped and
+ *	counted; the count is reported with a TRACE_LOST event.
+ *
+ *	The client decodes the events, see client/tracer.py.
+ *
+ *	2009	K.W.E. de Lange
+ */
+#include "define.h"
+#include "usart0.h"
+#include "trace.h"
+#include "event.h"
+
+#define TRACEMASK	(TRACESIZE - 1)
+
+static uint8_t ring[TRACESIZE];
+static uint8_t head, tail;				// free running indices, head - tail = bytes in use
+static uint8_t lost;					// number of events dropped since the last TRACE_LOST
+
+
+/*	Store an event with len bytes of arguments in the ring buffer.
+ *
+ */
+void trace(uint8_t id, const void *args, uint8_t len)
+{
+	uint8_t i;
+
+	if (lost) {
+		if (TRACESIZE - (uint8_t)(head - tail) < 2 + 1 + len) {
+			if (lost < 255)
+				lost++;
+			return;
+		}
+		ring[head++ & TRACEMASK] = TRACE_LOST;
+		ring[head++ & TRACEMASK] = lost;
+		lost = 0;
+	}
+
+	if (TRACESIZE - (uint8_t)(head - tail) < 1 + len) {
+		lost = 1;
+		return;
+	}
+
+	ring[head++ & TRACEMASK] = id;
+	for (i = 0; i < len; i++)
+		ring[head++ & TRACEMASK] = ((const uint8_t *)args)[i];
+
+	eventPost(EVENT_TRACE);
+}
+
+
+/*	Move traced bytes to the transmit buffer, without waiting for space.
+ *
+ */
+void traceTask(void)
+{
+	uint8_t n, room;
+
+	while ((n = head - tail) != 0) {
+		if (TRACESIZE - (tail & TRACEMASK) < n)				// copy up to the end of the ring first
+			n = TRACESIZE - (tail & TRACEMASK);
+
+		room = usart0outBufferFree() / 2;					// an escaped byte takes 2 bytes
+		if (room == 0)
+			break;
+		if (n > room)
+			n = room;
+
+		usart0WriteBlock(&ring[tail & TRACEMASK], n);
+		tail += n;
+	}
+}
@@ -0,0 +1,32 @@
+/*	trace.h
+ *
+ *	Defines for binary tracing of the scheduler
+ *
+ *	2009	K.W.E. de Lange
+ */
+#ifndef _TRACE_
+#define _TRACE_
+
+#include <stdint.h>
+
+#ifndef TRACESIZE
+#define TRACESIZE	64					// bytes in the trace ring buffer, must be a power of 2 and <= 128
+#endif
+
+/*	Event id's, followed by their arguments (integers are little-endian).
+ *	Keep in sync with the decoder in client/tracer.py.
+ *
+ */
+#define TRACE_LOST		0x80			// uint8 number of events lost because the ring buffer was full
+#define TRACE_VERBOSE	0x81			// none: tracing was switched on
+#define TRACE_POSITION	0x82			// uint16 index of the next action
+#define TRACE_CHECK		0x83			// dd, mm, yy, weekday, hrs, min, sec at the start of a check
+#define TRACE_EXECUTE	0x84			// uint16 from, uint16 to: interval checked in minutes since 00:00
+#define TRACE_DUE		0x85			// uint16 index, uint16 minute at which the action is due
+#define TRACE_ACTION	0x86			// major, minor, cmd of an action queued for transmission
+#define TRACE_CORRUPT	0x87			// uint16 index of an action with a wrong CRC, which is skipped
+
+void trace(uint8_t id, const void *args, uint8_t len);
+void traceTask(void);
+
+#endif /* _TRACE_ */
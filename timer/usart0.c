@@ -1,97 +1,242 @@
-/*	usart0.h
- *
- *	Interrupt-driven serial I/O.
- *
- *	2009	E. de Lange
- */
-#include "define.h"
-#include "usart0.h"
-
-
-/*	Transmit data structures - circular buffer
- *
- */
-static uint8_t TxBuf[TxBufLength];
-volatile static uint8_t TxWR, TxRD, numTx;
-
-/*	Receive data structures - circular buffer
- *
- */
-static uint8_t RxBuf[RxBufLength];
-volatile static uint8_t RxWR, RxRD, numRx;
-
-
-void usart0Init()
-{
-	UBRR0H = (uint8_t)((F_CPU/(BAUD*16L))-1)>>8;		// set baud rate
-	UBRR0L = (uint8_t) (F_CPU/(BAUD*16L))-1;
-   	UCSR0C = (1<<UCSZ01) | (1<<UCSZ00);					// 8N1
-	UCSR0B = (1<<RXCIE0) | (1<<RXEN0) | (1<<TXEN0); 	// enable receive and transmit interrupts
-   
-	TxWR = 0; TxRD = 0; numTx = 0;	 					// initialize Tx and Rx buffer pointers
-	RxWR = 0; RxRD = 0; numRx = 0;
-}
-
-
-/*	Interrupt routine to store a received byte in the circular input buffer.
- *	Overwrites the oldest byte if the buffer is full.
- *
- */
-ISR(USART_RX_vect)
-{
-	RxWR++;	
-	RxWR &= RxBufMask;									// efficient way to implement pointer wrapping
-	RxBuf[RxWR] = UDR0;
-	numRx++;
-}
-
-
-/*	Retrieve the next received byte, wait for a byte to become available.
- *
- */
-uint8_t usart0ReadByte(void)
-{
-	while (numRx == 0);
-
-	RxRD++;
-	RxRD &= RxBufMask;
-	numRx--; 
-
-	return RxBuf[RxRD];
-}
-
-
-/*	Interrupt routine to transmit bytes from the buffer.
- *
- */
-ISR(USART_UDRE_vect)
-{
-	if (numTx > 0) {
-		TxRD++;
-		TxRD &= TxBufMask;
-		UDR0 = TxBuf[TxRD]; 
-		numTx--; 
-	} else
-		UCSR0B &= ~(1<<UDRIE0);	 						// no more bytes, disable transmitter
-}
-
-
-/*	Write a byte to the transmission buffer, wait for space in buffer.
- *
- */
-void usart0WriteByte(uint8_t data)
-{
-	while (numTx == TxBufMask);
-
-	TxWR++;
-	TxWR &= TxBufMask;
-	TxBuf[TxWR] = data;
-	numTx++;
-	UCSR0B |= 1<<UDRIE0;								// enable transmitter (UDRE interrupt)
-}
-
-
-uint8_t usart0inBufferCount(void)
-{
-	return numRx;
-}
+/*	usart0.h
+ *
+ *	Interrupt-driven serial I/O.
+ *
+ *	2009	E. de Lange
+ */
+#include "define.h"
+#include "usart0.h"
+#include "statistics.h"
+#include "event.h"
+
+
+/*	Transmit data structures - circular buffer
+ *
+ *	The buffers are single-producer/single-consumer rings: the head index is only
+ *	written by the producer and the tail index only by the consumer. An 8-bit index
+ *	is read and written in a single instruction, so no counter has to be shared
+ *	and updated with interrupts disabled.
+ *
+ */
+static uint8_t TxBuf[TxBufLength];
+volatile static uint8_t TxHead;							// next free position, written by usart0WriteBlock()
+volatile static uint8_t TxTail;							// next byte to send, written by the UDRE interrupt
+
+/*	Receive data structures - circular buffer
+ *
+ */
+static uint8_t RxBuf[RxBufLength];
+volatile static uint8_t RxHead;							// next free position, written by the RX interrupt
+volatile static uint8_t RxTail;							// next byte to read, written by usart0ReadBlock()
+
+/*	Flow control state
+ *
+ */
+volatile static uint8_t RxStopped;						// <> 0 if XOFF was sent to the client
+volatile static uint8_t TxFlow;							// XON or XOFF waiting to be sent, 0 if none
+
+
+void usart0Init()
+{
+	UBRR0H = (uint8_t)((F_CPU/(BAUD*16L))-1)>>8;		// set baud rate
+	UBRR0L = (uint8_t) (F_CPU/(BAUD*16L))-1;
+   	UCSR0C = (1<<UCSZ01) | (1<<UCSZ00);					// 8N1
+	UCSR0B = (1<<RXCIE0) | (1<<RXEN0) | (1<<TXEN0); 	// enable receive and transmit interrupts
+   
+	TxHead = 0; TxTail = 0;			 					// initialize Tx and Rx buffer pointers
+	RxHead = 0; RxTail = 0;
+	RxStopped = 0; TxFlow = 0;
+}
+
+
+/*	Interrupt routine to store a received byte in the circular input buffer.
+ *	Asks the client to stop sending when the buffer is almost full. If the client
+ *	does not react in time and the buffer is full the received byte is lost.
+ *
+ */
+ISR(USART_RX_vect)
+{
+	uint8_t data = UDR0;
+	uint8_t head = RxHead;
+	uint8_t next = (head + 1) & RxBufMask;				// efficient way to implement pointer wrapping
+
+	if (next == RxTail) {								// buffer full, drop byte
+		statistics.rxOverflows++;
+		return;
+	}
+
+	RxBuf[head] = data;
+	RxHead = next;										// publish the byte
+
+	eventPostISR(EVENT_RX);
+
+	if (!RxStopped && ((next - RxTail) & RxBufMask) >= RxHighWater) {	// ask the client to pause
+		RxStopped = 1;
+		TxFlow = XOFF;
+		UCSR0B |= 1<<UDRIE0;
+	}
+}
+
+
+/*	Let the client resume sending once enough space is available in the receive buffer.
+ *	RxStopped is only set by the RX interrupt, so it is safe to test it first and
+ *	disable interrupts only in the rare case an XON must be sent.
+ *
+ */
+static void usart0RxResume(void)
+{
+	uint8_t sreg;
+
+	if (RxStopped && ((RxHead - RxTail) & RxBufMask) <= RxLowWater) {
+		sreg = SREG;
+		cli();
+		RxStopped = 0;
+		TxFlow = XON;
+		UCSR0B |= 1<<UDRIE0;
+		SREG = sreg;
+	}
+}
+
+
+/*	Retrieve len received bytes, wait for the bytes to become available.
+ *	Whatever is available is copied at once, the tail index is published only
+ *	after each run of bytes.
+ *
+ */
+void usart0ReadBlock(uint8_t *data, uint8_t len)
+{
+	uint8_t head, tail = RxTail;
+
+	while (len > 0) {
+		while ((head = RxHead) == tail);				// wait for data
+
+		do {
+			*data++ = RxBuf[tail];
+			tail = (tail + 1) & RxBufMask;
+		} while (--len > 0 && tail != head);
+
+		RxTail = tail;									// release the space to the RX interrupt
+		usart0RxResume();
+	}
+}
+
+
+/*	Retrieve the next received byte, wait for a byte to become available.
+ *
+ */
+uint8_t usart0ReadByte(void)
+{
+	uint8_t data;
+
+	usart0ReadBlock(&data, 1);
+
+	return data;
+}
+
+
+/*	Return the received byte at position offset without removing it from the buffer.
+ *	Only valid if usart0inBufferCount() > offset.
+ *
+ */
+uint8_t usart0Peek(uint8_t offset)
+{
+	return RxBuf[(RxTail + offset) & RxBufMask];
+}
+
+
+/*	Interrupt routine to transmit bytes from the buffer.
+ *
+ */
+ISR(USART_UDRE_vect)
+{
+	uint8_t tail = TxTail;
+
+	if (TxFlow) {										// flow control bytes go first
+		UDR0 = TxFlow;
+		TxFlow = 0;
+	} else if (tail != TxHead) {
+		UDR0 = TxBuf[tail];
+		TxTail = (tail + 1) & TxBufMask;
+	} else {
+		UCSR0B &= ~(1<<UDRIE0);	 						// no more bytes, disable transmitter
+		eventPostISR(EVENT_TX);
+	}
+}
+
+
+/*	Enable the transmitter (UDRE interrupt).
+ *	The interrupt routines only ever set UDRIE0, or clear it when the buffer is empty,
+ *	so setting it without disabling interrupts at worst causes one spurious interrupt.
+ *
+ */
+static inline void usart0TxStart(void)
+{
+	UCSR0B |= 1<<UDRIE0;
+}
+
+
+/*	Store a byte at position head of the transmission buffer and return the next
+ *	position. When the buffer is full the bytes stored so far are published and
+ *	the transmitter is started before waiting for space.
+ *
+ */
+static inline uint8_t usart0Put(uint8_t head, uint8_t data)
+{
+	uint8_t next = (head + 1) & TxBufMask;
+
+	if (next == TxTail) {
+		TxHead = head;
+		usart0TxStart();
+		while (next == TxTail);
+	}
+
+	TxBuf[head] = data;
+
+	return next;
+}
+
+
+/*	Write len data bytes to the transmission buffer, wait for space in buffer.
+ *	Flow control characters in the data are escaped.
+ *
+ */
+void usart0WriteBlock(const uint8_t *data, uint8_t len)
+{
+	uint8_t c, head = TxHead;
+
+	for (; len > 0; len--) {
+		c = *data++;
+		if (c == XON || c == XOFF || c == DLE) {
+			head = usart0Put(head, DLE);
+			c ^= 0x20;
+		}
+		head = usart0Put(head, c);
+	}
+
+	TxHead = head;										// publish the bytes
+	usart0TxStart();
+}
+
+
+/*	Write a data byte to the transmission buffer.
+ *
+ */
+void usart0WriteByte(uint8_t data)
+{
+	usart0WriteBlock(&data, 1);
+}
+
+
+uint8_t usart0inBufferCount(void)
+{
+	return (RxHead - RxTail) & RxBufMask;
+}
+
+
+/*	Number of bytes which can be written to the transmission buffer without waiting.
+ *
+ */
+uint8_t usart0outBufferFree(void)
+{
+	return (TxTail - TxHead - 1) & TxBufMask;
+}
@@ -1,38 +1,77 @@
-/*	usart0.h
- *
- *	Defines for handling serial communication using USART0
- *
- *	2008	K.W.E. de Lange
- */
-#ifndef _USART0_
-#define _USART0_
-
-#include <avr/io.h>
-#include <avr/interrupt.h>
-
-#define TxBufLength 32
-#define TxBufMask 	TxBufLength - 1
-#define RxBufLength 128
-#define RxBufMask 	RxBufLength - 1
-
-/*	Pointer wrapping in the circular buffers is implemented by masking unused high bits.
- *	This only works if the mask can be a power of 2. 
- *
- */
-#if (TxBufLength & TxBufMask)
-#error TxBufLength size is not a power of 2
-#endif
-
-#if (RxBufLength & RxBufMask)
-#error RxBufLength size is not a power of 2
-#endif
-
-void usart0Init(void);
-void usart0WriteByte(uint8_t data);
-uint8_t usart0ReadByte(void);
-uint8_t usart0inBufferCount(void);
-
-#define getch	usart0ReadByte
-#define putch	usart0WriteByte
-
-#endif /* _USART0_ */
+/*	usart0.h
+ *
+ *	Defines for handling serial communication using USART0
+ *
+ *	2008	K.W.E. de Lange
+ */
+#ifndef _USART0_
+#define _USART0_
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*	Buffer sizes can be overruled from the compiler command line (-DTxBufLength=..).
+ *	A larger transmit buffer keeps the line busy during bulk transfers, a larger
+ *	receive buffer absorbs longer bursts from the client.
+ *
+ */
+#ifndef TxBufLength
+#define TxBufLength 64
+#endif
+#define TxBufMask 	(TxBufLength - 1)
+#ifndef RxBufLength
+#define RxBufLength 128
+#endif
+#define RxBufMask 	(RxBufLength - 1)
+
+/*	Software flow control. When the receive buffer fills up to RxHighWater an XOFF is
+ *	sent to the client, once it has drained to RxLowWater an XON follows.
+ *	As the client's serial driver consumes every XON and XOFF it receives, these bytes
+ *	(and the escape byte itself) are escaped when they occur in transmitted data:
+ *	DLE followed by the byte XOR 0x20.
+ *
+ */
+#define XON			0x11
+#define XOFF		0x13
+#define DLE			0x10
+
+#define RxHighWater	(RxBufLength * 3 / 4)
+#define RxLowWater	(RxBufLength / 4)
+
+/*	Pointer wrapping in the circular buffers is implemented by masking unused high bits.
+ *	This only works if the mask can be a power of 2. One position of each buffer is
+ *	always kept empty to tell a full buffer from an empty one.
+ *
+ */
+#if (TxBufLength & TxBufMask)
+#error TxBufLength size is not a power of 2
+#endif
+
+#if (RxBufLength & RxBufMask)
+#error RxBufLength size is not a power of 2
+#endif
+
+/*	Buffer indices are 8 bits, and the buffers may not claim more than a quarter of the SRAM.
+ *
+ */
+#if (TxBufLength > 256 || RxBufLength > 256)
+#error TxBufLength or RxBufLength larger than 256
+#endif
+
+#if (TxBufLength + RxBufLength > (RAMEND - RAMSTART + 1) / 4)
+#error TxBufLength and RxBufLength use too much SRAM
+#endif
+
+void usart0Init(void);
+void usart0WriteByte(uint8_t data);
+void usart0WriteBlock(const uint8_t *data, uint8_t len);
+uint8_t usart0ReadByte(void);
+void usart0ReadBlock(uint8_t *data, uint8_t len);
+uint8_t usart0Peek(uint8_t offset);
+uint8_t usart0inBufferCount(void);
+uint8_t usart0outBufferFree(void);
+
+#define getch	usart0ReadByte
+#define putch	usart0WriteByte
+
+#endif /* _USART0_ */
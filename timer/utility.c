@@ -1,47 +1,104 @@
-/*	utility.h
- *
- *	Various utility routines
- *
- *	2008	K.W.E. de Lange
- */
-
-
-/*	Convert a packed BCD byte to an 8-bit integer. 
- *
- *	In packed BCD every nibble of a byte represents a digit. 
- *
- *	The input (char b) is a byte containing big-endian packed BCD; so the high nibble (bits 4-7) 
- *	represents the 10's, the low nibble (bits 0-4) the 1's.
- *
- */
-unsigned char bcd2int(unsigned char b)
-{ 
-	unsigned char r; 
-
-	r  = ((b >> 4) & 0x0F) * 10; 
-	r += (b & 0x0F); 
-
-	return r; 
-}
-
-
-/*	Convert an 8-bit integer to a packed BCD byte.
- *
- *	In packed BCD every nibble of a byte represents a digit. 
- *
- *	The output (r) is a byte containing big-endian packed BCD; so the high nibble (bits 4-7) 
- *	represents the 10's, the low nibble (bits 0-4) the 1's.
- */
-unsigned char int2bcd(unsigned char b)
-{ 
-	unsigned char r; 
-	unsigned char tmp1, tmp2; 
-    
-	tmp1 = b / 10; 
-	tmp2 = b - tmp1 * 10; 
-
-	r  = (tmp1 << 4) & 0xF0; 
-	r += (tmp2 & 0x0F); 
-
-	return r;
-}
+/*	utility.h
+ *
+ *	Various utility routines
+ *
+ *	2008	K.W.E. de Lange
+ */
+#include <avr/pgmspace.h>
+#include "profile.h"
+
+
+/*	Convert a packed BCD byte to an 8-bit integer. 
+ *
+ *	In packed BCD every nibble of a byte represents a digit. 
+ *
+ *	The input (char b) is a byte containing big-endian packed BCD; so the high nibble (bits 4-7) 
+ *	represents the 10's, the low nibble (bits 0-4) the 1's.
+ *
+ */
+unsigned char bcd2int(unsigned char b)
+{ 
+	unsigned char r; 
+
+	PROFILE_ENTER(PROFILE_BCD2INT);
+
+	r  = ((b >> 4) & 0x0F) * 10; 
+	r += (b & 0x0F); 
+
+	PROFILE_EXIT(PROFILE_BCD2INT);
+
+	return r; 
+}
+
+
+/*	Convert an 8-bit integer to a packed BCD byte.
+ *
+ *	In packed BCD every nibble of a byte represents a digit. 
+ *
+ *	The output (r) is a byte containing big-endian packed BCD; so the high nibble (bits 4-7) 
+ *	represents the 10's, the low nibble (bits 0-4) the 1's.
+ */
+unsigned char int2bcd(unsigned char b)
+{ 
+	unsigned char r; 
+	unsigned char tmp1, tmp2; 
+    
+	tmp1 = b / 10; 
+	tmp2 = b - tmp1 * 10; 
+
+	r  = (tmp1 << 4) & 0xF0; 
+	r += (tmp2 & 0x0F); 
+
+	return r;
+}
+
+
+/*	Convert an unsigned integer to a right aligned decimal string of exactly width characters.
+ *
+ *	Leading positions are filled with character pad (like '0' or ' '). If the value has
+ *	more digits than width only the lowest digits are stored. No terminating zero is added.
+ *
+ */
+void uint2str(char *s, unsigned long value, unsigned char width, char pad)
+{
+	unsigned char i = width;
+
+	do {
+		s[--i] = '0' + value % 10;
+		value /= 10;
+	} while (value != 0 && i > 0);
+
+	while (i > 0)
+		s[--i] = pad;
+}
+
+
+/*	Return the day of the year of a date, 0 for 1 January.
+ *
+ *	leap	<> 0 if the date is in a leap year
+ *
+ */
+unsigned int dayOfYear(unsigned char dd, unsigned char mm, unsigned char leap)
+{
+	static const unsigned int firstDay[12] PROGMEM = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+	unsigned int n;
+
+	n = pgm_read_word(&firstDay[mm - 1]) + dd - 1;
+
+	if (mm > 2 && leap)										// past February in a leap year
+		n++;
+
+	return n;
+}
+
+
+/*	Convert a date to a day number: the number of days since 1 January 2000.
+ *
+ *	Valid for years 2000 (yy = 0) to 2099 (yy = 99), in which every fourth year is a
+ *	leap year. Two dates can then be compared with a single integer comparison.
+ *
+ */
+unsigned int dayNumber(unsigned char dd, unsigned char mm, unsigned char yy)
+{
+	return yy * 365 + (yy + 3) / 4 + dayOfYear(dd, mm, (yy & 3) == 0);	// (yy + 3) / 4 of the previous years were leap years
+}
@@ -1,18 +1,21 @@
-/*	utility.h
- *
- *	Various utilities not related to a specific project
- *
- *	2008	K.W.E. de Lange
- */
-#ifndef _UTILITY_
-#define _UTILITY_
-
-#define bitSet(p, m) ((p) |= (m))
-#define bitClr(p, m) ((p) &= ~(m)) 
-
-typedef enum {FALSE = 0, TRUE} boolean;
-
-unsigned char int2bcd(unsigned char b);
-unsigned char bcd2int(unsigned char b);
-
-#endif /* _UTILITY_ */
+/*	utility.h
+ *
+ *	Various utilities not related to a specific project
+ *
+ *	2008	K.W.E. de Lange
+ */
+#ifndef _UTILITY_
+#define _UTILITY_
+
+#define bitSet(p, m) ((p) |= (m))
+#define bitClr(p, m) ((p) &= ~(m)) 
+
+typedef enum {FALSE = 0, TRUE} boolean;
+
+unsigned char int2bcd(unsigned char b);
+unsigned char bcd2int(unsigned char b);
+void uint2str(char *s, unsigned long value, unsigned char width, char pad);
+unsigned int dayNumber(unsigned char dd, unsigned char mm, unsigned char yy);
+unsigned int dayOfYear(unsigned char dd, unsigned char mm, unsigned char leap);
+
+#endif /* _UTILITY_ */